@@ -0,0 +1,45 @@
+#include "benchmark.h"
+#include "trees.h"
+#include "tui/asyncpresenter.h"
+#include "tui/presenter.h"
+#include <thread>
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+// Slow terminal (or remote link): writing a frame takes 1 ms.
+struct SlowSink : Sink {
+    void write(std::string_view) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds {1});
+    }
+};
+
+// Each frame is built, then presented by the producer itself:
+// the producer runs at the speed of the terminal.
+void present_sync(State& state) {
+    SlowSink sink;
+    Presenter presenter {sink};
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto root = make_debugger();
+        presenter.present(*root);
+    }
+}
+
+// Each frame is built, then handed over to the render thread:
+// the frames the terminal cannot keep up with are dropped.
+void present_async(State& state) {
+    SlowSink sink;
+    Presenter presenter {sink};
+    AsyncPresenter async {presenter};
+
+    for ([[maybe_unused]] auto _ : state) {
+        async.submit(make_debugger());
+    }
+    async.wait();
+}
+} // namespace
+
+BENCHMARK(present_sync, "async/debugger/sync")
+BENCHMARK(present_async, "async/debugger/async")
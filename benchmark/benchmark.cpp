@@ -0,0 +1,110 @@
+#include "benchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace Tui::Benchmark {
+namespace {
+    // Updated by every thread allocating (e.g. the threads presenting bands):
+    // only the totals matter, not their order with other memory accesses.
+    std::atomic<uint64_t> allocation_count {};
+    std::atomic<uint64_t> allocation_bytes {};
+
+    struct Entry {
+        const char* name;
+        Function function;
+    };
+
+    std::vector<Entry>& registry() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+} // namespace
+
+uint64_t allocations() {
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+uint64_t allocated_bytes() {
+    return allocation_bytes.load(std::memory_order_relaxed);
+}
+
+State::Iterator State::begin() {
+    start_allocations = Benchmark::allocations();
+    start_allocated_bytes = Benchmark::allocated_bytes();
+    start_time = std::chrono::steady_clock::now();
+    return {this, iterations};
+}
+
+State::Iterator State::end() {
+    return {this, 0};
+}
+
+void State::stop() {
+    elapsed = std::chrono::steady_clock::now() - start_time;
+    allocations = Benchmark::allocations() - start_allocations;
+    allocated_bytes = Benchmark::allocated_bytes() - start_allocated_bytes;
+}
+
+Registration::Registration(const char* name, Function function) {
+    registry().push_back({name, function});
+}
+
+std::vector<Result> run(const std::string& filter, std::chrono::milliseconds min_time) {
+    std::vector<Result> results;
+
+    for (const auto& entry : registry()) {
+        if (std::string {entry.name}.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        // Warm up, then grow the number of iterations until the run is long enough
+        uint64_t iterations = 1;
+        State state {iterations};
+        entry.function(state);
+
+        while (state.elapsed < min_time && iterations < (1ULL << 40)) {
+            double ns = std::chrono::duration<double, std::nano>(state.elapsed).count();
+            double target = std::chrono::duration<double, std::nano>(min_time).count();
+            uint64_t next = ns > 0 ? static_cast<uint64_t>(static_cast<double>(iterations) * target / ns * 1.2) : 0;
+            iterations = std::max(iterations * 2, std::min(next, iterations * 100));
+
+            state = State {iterations};
+            entry.function(state);
+        }
+
+        auto n = static_cast<double>(state.iterations);
+        double ns = std::chrono::duration<double, std::nano>(state.elapsed).count();
+
+        Result result;
+        result.name = entry.name;
+        result.iterations = state.iterations;
+        result.ns_per_op = ns / n;
+        result.allocations_per_op = static_cast<double>(state.allocations) / n;
+        result.bytes_per_op = static_cast<double>(state.allocated_bytes) / n;
+        result.items_per_second = static_cast<double>(state.items_per_iteration) * n / ns * 1e9;
+        result.output_bytes_per_op = state.output_bytes_per_iteration;
+        result.failed = state.expect_no_allocations && state.allocations > 0;
+        results.push_back(result);
+    }
+
+    return results;
+}
+} // namespace Tui::Benchmark
+
+// Count every heap allocation of the process.
+void* operator new(std::size_t size) {
+    Tui::Benchmark::allocation_count.fetch_add(1, std::memory_order_relaxed);
+    Tui::Benchmark::allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
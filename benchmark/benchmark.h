@@ -0,0 +1,112 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Tui::Benchmark {
+// Number of heap allocations (and allocated bytes) performed so far.
+uint64_t allocations();
+uint64_t allocated_bytes();
+
+// State of a benchmark run.
+// The benchmark function performs its setup, then iterates over
+// the state: only the loop is measured.
+//
+//     void bench(State& state) {
+//         Text t {"hello"};
+//         for ([[maybe_unused]] auto _ : state) {
+//             do_not_optimize(t.rpad(Text::Length {16}));
+//         }
+//     }
+class State {
+public:
+    struct Iterator {
+        bool operator!=(const Iterator&) {
+            if (remaining > 0) {
+                remaining--;
+                return true;
+            }
+            state->stop();
+            return false;
+        }
+        Iterator& operator++() {
+            return *this;
+        }
+        int operator*() const {
+            return 0;
+        }
+
+        State* state;
+        uint64_t remaining;
+    };
+
+    explicit State(uint64_t iterations) :
+        iterations {iterations} {
+    }
+
+    Iterator begin();
+    Iterator end();
+
+    uint64_t iterations;
+
+    // Number of items processed per iteration (e.g. bytes), reported as throughput.
+    uint64_t items_per_iteration {};
+
+    // Number of bytes written per iteration (e.g. bytes of a frame).
+    uint64_t output_bytes_per_iteration {};
+
+    // Whether the measured loop must not perform any heap allocation:
+    // the run is reported as failed otherwise.
+    bool expect_no_allocations {};
+
+    std::chrono::steady_clock::duration elapsed {};
+    uint64_t allocations {};
+    uint64_t allocated_bytes {};
+
+private:
+    void stop();
+
+    std::chrono::steady_clock::time_point start_time {};
+    uint64_t start_allocations {};
+    uint64_t start_allocated_bytes {};
+};
+
+using Function = void (*)(State&);
+
+struct Registration {
+    Registration(const char* name, Function function);
+};
+
+struct Result {
+    std::string name;
+    uint64_t iterations {};
+    double ns_per_op {};
+    double allocations_per_op {};
+    double bytes_per_op {};
+    double items_per_second {};
+    uint64_t output_bytes_per_op {};
+    bool failed {};
+};
+
+// Runs the registered benchmarks whose name contains the filter,
+// each one for at least the given time.
+std::vector<Result> run(const std::string& filter, std::chrono::milliseconds min_time);
+
+// Prevents the compiler from optimizing away the computation of a value.
+template <typename T>
+void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+} // namespace Tui::Benchmark
+
+#define BENCHMARK_CONCAT_(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_(a, b)
+
+// Registers a benchmark function under the given name.
+#define BENCHMARK(function, name)                                                                                      \
+    static const Tui::Benchmark::Registration BENCHMARK_CONCAT(registration_, __LINE__) {name, function};
+
+#endif // BENCHMARK_H
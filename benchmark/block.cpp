@@ -0,0 +1,122 @@
+#include "benchmark.h"
+#include "tui/block.h"
+#include "tui/decorators.h"
+#include "tui/format.h"
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+void block_append(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        Block block;
+        block << "name: " << 42 << endl;
+        block << "value: " << red("off") << endl;
+        do_not_optimize(block);
+    }
+}
+
+void block_append_newlines(State& state) {
+    Text text {"first line\nsecond line\nthird line\n"};
+    state.items_per_iteration = 3;
+    for ([[maybe_unused]] auto _ : state) {
+        Block block;
+        block << text;
+        do_not_optimize(block);
+    }
+}
+
+void block_append_many(State& state) {
+    // Lines appended one by one to the same block, as a log does
+    state.items_per_iteration = 100;
+    for ([[maybe_unused]] auto _ : state) {
+        Block block;
+        for (uint32_t i = 0; i < 100; i++) {
+            block << "line " << i << endl;
+        }
+        do_not_optimize(block);
+    }
+}
+void block_append_large_string(State& state) {
+    // Output of an external tool streamed into a block
+    std::string str;
+    for (uint32_t i = 0; i < 1000; i++) {
+        str += "  40" + std::to_string(1000 + i) + ":\t48 89 e5             mov    %rsp,%rbp\n";
+    }
+    state.items_per_iteration = str.size();
+    for ([[maybe_unused]] auto _ : state) {
+        Block block;
+        block << std::string_view {str};
+        do_not_optimize(block);
+    }
+}
+
+void block_append_large_text(State& state) {
+    std::string str;
+    for (uint32_t i = 0; i < 1000; i++) {
+        str += "  40" + std::to_string(1000 + i) + ":\t48 89 e5             mov    %rsp,%rbp\n";
+    }
+    Text text {str};
+    state.items_per_iteration = str.size();
+    for ([[maybe_unused]] auto _ : state) {
+        Block block;
+        block << text;
+        do_not_optimize(block);
+    }
+}
+
+void block_refill(State& state) {
+    // Block cleared and filled again at each frame
+    Block block;
+    block.reserve(100);
+    state.items_per_iteration = 100;
+    for (uint32_t i = 0; i < 2; i++) {
+        block.clear();
+        for (uint32_t j = 0; j < 100; j++) {
+            block << "line " << j << endl;
+        }
+    }
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        block.clear();
+        for (uint32_t j = 0; j < 100; j++) {
+            block << "line " << std::string_view {"value"} << endl;
+        }
+        do_not_optimize(block);
+    }
+}
+
+void block_refill_moved(State& state) {
+    // Lines composed apart, then moved into the block: the storage of the replaced lines
+    // is handed back to be reused by the next ones
+    Block block;
+    block.reserve(100);
+    Text line;
+    const auto fill = [&block, &line] {
+        block.clear();
+        for (uint32_t j = 0; j < 100; j++) {
+            line += fmt("line {:3}", j);
+            block << std::move(line) << endl;
+        }
+    };
+    state.items_per_iteration = 100;
+    for (uint32_t i = 0; i < 2; i++) {
+        fill();
+    }
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        fill();
+        do_not_optimize(block);
+    }
+}
+} // namespace
+
+BENCHMARK(block_append, "block/append")
+BENCHMARK(block_append_newlines, "block/append_newlines")
+BENCHMARK(block_append_many, "block/append_100_lines")
+BENCHMARK(block_append_large_string, "block/append_large_string")
+BENCHMARK(block_append_large_text, "block/append_large_text")
+BENCHMARK(block_refill, "block/refill")
+BENCHMARK(block_refill_moved, "block/refill/moved")
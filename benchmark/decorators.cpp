@@ -0,0 +1,53 @@
+#include "benchmark.h"
+#include "tui/decorators.h"
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+void decorators_red(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(red("error"));
+    }
+}
+
+void decorators_color(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(color<208>("warning"));
+    }
+}
+
+void decorators_nested(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(bold(lightblue("title")));
+    }
+}
+
+void decorators_constant(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(Red("error"));
+    }
+}
+
+void decorators_constant_append(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        Text line;
+        Red.append(line, "error");
+        Color<208>.append(line, "warning");
+        do_not_optimize(line);
+    }
+}
+
+void decorators_reset(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(reset());
+    }
+}
+} // namespace
+
+BENCHMARK(decorators_red, "decorators/red")
+BENCHMARK(decorators_color, "decorators/color")
+BENCHMARK(decorators_nested, "decorators/nested")
+BENCHMARK(decorators_constant, "decorators/constant")
+BENCHMARK(decorators_constant_append, "decorators/constant_append")
+BENCHMARK(decorators_reset, "decorators/reset")
@@ -0,0 +1,724 @@
+#include "reference.h"
+#include "trees.h"
+#include "tui/builder.h"
+#include "tui/container.h"
+#include "tui/decorators.h"
+#include "tui/divider.h"
+#include "tui/factory.h"
+#include "tui/fileblock.h"
+#include "tui/hlayout.h"
+#include "tui/layout.h"
+#include "tui/logblock.h"
+#include "tui/presenter.h"
+#include "tui/virtualblock.h"
+#include "tui/vlayout.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+namespace Tui::Benchmark {
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Presenter configurations expected to write the same bytes as the reference
+    // (or to render the same text).
+    struct Configuration {
+        const char* name;
+        Presenter::Mode mode;
+        uint32_t threads;
+        bool viewport;
+        // Rendered into a surface: its text is compared with the one displayed for the reference.
+        bool surface;
+        // Copied into a builder at each frame, which is presented instead of the tree.
+        bool builder;
+        // Presents a random part of each frame: its text is compared with the one displayed
+        // for the same part of the reference.
+        bool window;
+    };
+
+    constexpr Configuration Configurations[] = {
+        {"immediate", Presenter::Mode::Immediate, 1, false, false, false, false},
+        {"retained", Presenter::Mode::Retained, 1, false, false, false, false},
+        {"threads", Presenter::Mode::Immediate, 4, false, false, false, false},
+        {"viewport", Presenter::Mode::Retained, 1, true, false, false, false},
+        {"surface", Presenter::Mode::Retained, 1, false, true, false, false},
+        {"builder", Presenter::Mode::Retained, 1, false, false, true, false},
+        {"window", Presenter::Mode::Retained, 1, false, false, false, true},
+        {"window/immediate", Presenter::Mode::Immediate, 1, false, false, false, true},
+        {"window/surface", Presenter::Mode::Retained, 1, false, true, false, true},
+    };
+
+    constexpr uint32_t ConfigurationCount = sizeof(Configurations) / sizeof(Configurations[0]);
+
+    // Frames presented for each tree: the tree is modified between them.
+    constexpr uint32_t Frames = 3;
+
+    struct Candidate {
+        explicit Candidate(const Configuration& configuration) :
+            presenter {sink, configuration.mode} {
+            presenter.set_threads(configuration.threads);
+            if (configuration.viewport) {
+                // Covers the whole frame, whatever its size
+                presenter.set_viewport(Presenter::Viewport {UINT32_MAX, UINT32_MAX, 0, 0});
+            }
+        }
+
+        std::string output;
+        StringSink sink {output};
+        Presenter presenter;
+        Surface surface;
+        Builder builder;
+    };
+
+    // The reference expects blocks of at least one line: a block without lines is given an empty one,
+    // laid out the same (the empty lines ending a block count neither in its height nor in its width).
+    std::unique_ptr<Node> with_line(std::unique_ptr<Block> block) {
+        if (block->lines.empty()) {
+            block->lines.emplace_back();
+        }
+        return block;
+    }
+
+    // Copy of the tree made of blocks, dividers and layouts only (as supported by the reference):
+    // the other content nodes are replaced by blocks of the lines they present, with their width (none otherwise).
+    std::unique_ptr<Node> as_blocks(const Node& node) {
+        if (node.type == Node::Type::Block) {
+            const auto& block = static_cast<const Block&>(node);
+            auto copy = make_block(block.width);
+            copy->lines = block.lines;
+            return with_line(std::move(copy));
+        }
+        if (node.type == Node::Type::Divider) {
+            return make_divider(Text {static_cast<const Divider&>(node).text});
+        }
+        if (node.type == Node::Type::HLayout || node.type == Node::Type::VLayout) {
+            std::unique_ptr<Container> copy;
+            if (node.type == Node::Type::HLayout)
+                copy = make_horizontal_layout();
+            else
+                copy = make_vertical_layout();
+            for (const auto& child : static_cast<const Container&>(node).children) {
+                if (auto child_copy = as_blocks(*child)) {
+                    copy->add_node(std::move(child_copy));
+                }
+            }
+            return copy;
+        }
+
+        if (node.type == Node::Type::Flattened) {
+            // A static layout presents nothing in a dynamic tree: it is left out
+            return nullptr;
+        }
+        if (node.type == Node::Type::FileBlock) {
+            const auto& block = static_cast<const FileBlock&>(node);
+            auto copy = make_block(block.width.value_or(0));
+            for (uint32_t i = 0; i < block.count(); i++) {
+                copy->lines.emplace_back();
+                block.append_line(i, copy->lines.back());
+            }
+            return with_line(std::move(copy));
+        }
+        if (node.type == Node::Type::LogBlock) {
+            const auto& block = static_cast<const LogBlock&>(node);
+            auto copy = make_block(block.width.value_or(0));
+            for (uint32_t i = 0; i < block.presented(); i++) {
+                copy->lines.push_back(block.line(i));
+            }
+            return with_line(std::move(copy));
+        }
+
+        const auto& block = static_cast<const VirtualBlock&>(node);
+        auto copy = make_block(block.width.value_or(0));
+        for (uint32_t i = 0; i < block.count; i++) {
+            copy->lines.emplace_back();
+            block.provider(i, copy->lines.back());
+        }
+        return with_line(std::move(copy));
+    }
+
+    // Small trees of shapes the random trees do not produce.
+    struct Case {
+        const char* name;
+        std::unique_ptr<Node> (*make)();
+    };
+
+    std::unique_ptr<Node> make_lines(std::optional<uint32_t> width) {
+        return make_virtual_block(
+            3, [](uint32_t index, Text& line) { line += Text {"line "} + Text {index}; }, width);
+    }
+
+    std::unique_ptr<Node> make_log(std::optional<uint32_t> width) {
+        auto log = make_log_block(2, width);
+        for (uint32_t i = 0; i < 3; i++) {
+            log << "log " << i << endl;
+        }
+        return log;
+    }
+
+    // File of 3 lines, removed at exit.
+    const std::string& lines_file() {
+        static const struct File {
+            File() {
+                path = (std::filesystem::temp_directory_path() / "tui-differential-XXXXXX").string();
+                int fd = ::mkstemp(path.data());
+                std::string_view bytes = "file 0\nfile 1\nfile 2\n";
+                bool written = fd >= 0 && ::write(fd, bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size());
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                if (!written) {
+                    std::printf("cannot write %s\n", path.c_str());
+                }
+            }
+            ~File() {
+                ::unlink(path.c_str());
+            }
+            std::string path;
+        } file;
+        return file.path;
+    }
+
+    std::unique_ptr<Node> make_file(std::optional<uint32_t> width) {
+        auto file = make_file_block(width);
+        file->open(lines_file());
+        file->index();
+        return file;
+    }
+
+    std::unique_ptr<Node> make_static() {
+        auto layout = std::make_unique<Static::HLayout<Static::Block<>, Static::Divider<'|'>, Static::Block<>>>();
+        layout->get<0>() << "left" << endl;
+        layout->get<2>() << "right" << endl;
+        return layout;
+    }
+
+    std::unique_ptr<Node> make_text(const char* text, std::optional<uint32_t> width = std::nullopt) {
+        auto block = make_block(width);
+        block << text << endl;
+        return block;
+    }
+
+    template <typename... Nodes>
+    std::unique_ptr<Node> make_row(std::unique_ptr<Nodes>... nodes) {
+        std::unique_ptr<Container> row = make_horizontal_layout();
+        (row->add_node(std::move(nodes)), ...);
+        return row;
+    }
+
+    template <typename... Nodes>
+    std::unique_ptr<Node> make_column(std::unique_ptr<Nodes>... nodes) {
+        std::unique_ptr<Container> column = make_vertical_layout();
+        (column->add_node(std::move(nodes)), ...);
+        return column;
+    }
+
+    const Case Cases[] = {
+        {"virtual/first", [] { return make_row(make_lines(std::nullopt), make_text("abc"), make_text("xyz")); }},
+        {"virtual/middle", [] { return make_row(make_text("abc"), make_lines(std::nullopt), make_text("xyz")); }},
+        {"virtual/last", [] { return make_row(make_text("abc"), make_lines(std::nullopt)); }},
+        {"virtual/fixed", [] { return make_row(make_lines(4), make_text("abc")); }},
+        {"log/first", [] { return make_row(make_log(std::nullopt), make_text("abc"), make_text("xyz")); }},
+        {"log/middle", [] { return make_row(make_text("abc"), make_log(std::nullopt), make_text("xyz")); }},
+        {"log/last", [] { return make_row(make_text("abc"), make_log(std::nullopt)); }},
+        {"log/fixed", [] { return make_row(make_log(4), make_text("abc")); }},
+        {"file/first", [] { return make_row(make_file(std::nullopt), make_text("abc"), make_text("xyz")); }},
+        {"file/middle", [] { return make_row(make_text("abc"), make_file(std::nullopt), make_text("xyz")); }},
+        {"file/last", [] { return make_row(make_text("abc"), make_file(std::nullopt)); }},
+        {"file/fixed", [] { return make_row(make_file(4), make_text("abc")); }},
+        {"static/middle", [] { return make_row(make_text("abc"), make_static(), make_text("xyz")); }},
+        {"static/last", [] { return make_row(make_text("abc"), make_static()); }},
+        {"wide/fits", [] { return make_row(make_text("a\u6F22c", 3), make_text("xyz")); }},
+        {"combining", [] { return make_row(make_text("e\u0301x\u0301", 3), make_text("\u0301xyz")); }},
+        {"sgr/unknown", [] { return make_row(make_text("\033[58;5;196mab\033[0m"), make_text("\033[58;2;1;2;3mxyz")); }},
+    };
+
+    // Small trees presented differently from the reference, which is kept as it was first written
+    // (so that it does not change with the presenter it checks): their output is given instead.
+    struct Output {
+        const char* name;
+        std::unique_ptr<Node> (*make)();
+        const char* output;
+        // Presented with minimal SGR sequences (see Presenter::set_minimal_sgr()).
+        bool minimal_sgr {};
+    };
+
+    const Output Outputs[] = {
+        // A wide character that does not fit in the last column is replaced by a space
+        {"wide/edge", [] { return make_row(make_text("ab\u6F22c", 3), make_text("xyz")); },
+         "ab \033[0mxyz\033[0m\n"},
+        {"wide/styled", [] { return make_row(make_text("\033[1mab\u6F22\033[0mc", 3), make_text("xyz")); },
+         "\033[1mab \033[0mxyz\033[0m\n"},
+        {"wide/narrow", [] { return make_row(make_text("\u6F22", 1), make_text("xyz")); },
+         " \033[0mxyz\033[0m\n"},
+        // A block without lines is as wide as its width (0 by default), without rows of its own
+        // (the first row of a vertical layout presents its first child, as the reference)
+        {"empty/first", [] { return make_row(make_block(), make_text("abc")); }, "\033[0mabc\033[0m\n"},
+        {"empty/fixed", [] { return make_row(make_block(2), make_text("abc")); }, "  \033[0mabc\033[0m\n"},
+        {"empty/column", [] { return make_column(make_block(), make_text("abc"), make_block()); },
+         "   \033[0m\nabc\033[0m\n"},
+        // The last repetition of a divider is truncated to its width, then reset
+        {"divider/truncated", [] { return make_column(make_text("abcde"), make_divider("-=")); },
+         "abcde\033[0m\n-=-=-\033[0m\n"},
+        {"divider/styled", [] { return make_column(make_text("abc"), make_divider(red("-="))); },
+         "abc\033[0m\n\033[31m-=\033[0m\033[31m-\033[0m\n"},
+        // A divider without text is blank
+        {"divider/empty", [] { return make_column(make_text("abc"), make_divider("")); }, "abc\033[0m\n   \n"},
+        {"divider/empty/row", [] { return make_row(make_text("ab"), make_divider(""), make_text("c")); },
+         "ab\033[0mc\033[0m\n"},
+        // A SGR sequence with a parameter a style does not represent (an underline color) is written as is,
+        // as the next ones until the terminal is reset
+        {"sgr/unknown", [] { return make_row(make_text("\033[58;5;196mab"), make_text("\033[1mc\033[0md")); },
+         "\033[58;5;196mab\033[0m\033[1mc\033[0md\n", true},
+        {"sgr/unknown/reset", [] { return make_row(make_text("\033[4;58;5;196mab\033[0mc"), make_text("\033[1mxyz")); },
+         "\033[4;58;5;196mab\033[0mc\033[1mxyz\n\033[0m", true},
+    };
+
+    // Tokens of texts with escape characters, each written as bytes:size: a lone ESC
+    // is a zero width token that leaves the next character as it is.
+    struct Tokens {
+        const char* text;
+        const char* tokens;
+    };
+
+    const Tokens Texts[] = {
+        {"\033", "\033:0"},
+        {"a\033\nb", "a:1 \033:0 \n:1 b:1"},
+        {"\033\u00E9", "\033:0 \u00E9:1"},
+        {"\033\u6F22", "\033:0 \u6F22:2"},
+        {"\033\033[1m", "\033:0 \033[1m:0"},
+        {"\033(Bx", "\033(B:0 x:1"},
+        {"\0337x", "\0337:0 x:1"},
+        {"\033]0;title\007x", "\033]0;title\007:0 x:1"},
+    };
+
+    // Copies the tree into the builder, as the frame of an application built in immediate mode.
+    void build(Builder& builder, const Node& node) {
+        if (node.type == Node::Type::Block) {
+            const auto& block = static_cast<const Block&>(node);
+            Block& copy = builder.block(block.width);
+            copy.lines = block.lines;
+            copy.height = block.height;
+            copy.offset = block.offset;
+        } else if (node.type == Node::Type::Divider) {
+            builder.divider(static_cast<const Divider&>(node).text);
+        } else if (node.type == Node::Type::HLayout || node.type == Node::Type::VLayout) {
+            if (node.type == Node::Type::HLayout) {
+                builder.begin_horizontal_layout();
+            } else {
+                builder.begin_vertical_layout();
+            }
+            for (const auto& child : static_cast<const Container&>(node).children) {
+                build(builder, *child);
+            }
+            builder.end_layout();
+        } else {
+            builder.add(node);
+        }
+    }
+
+    uint64_t elapsed_ns(Clock::time_point start) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    std::string present_reference(const Node& root, uint64_t& ns) {
+        std::ostringstream os;
+        auto start = Clock::now();
+        ReferencePresenter {os}.present(root);
+        ns += elapsed_ns(start);
+        return os.str();
+    }
+
+    // Whether a line of the block has a wide character.
+    bool has_wide(const Block& block) {
+        bool wide = false;
+        for (const auto& line : block.lines) {
+            line.for_each([&wide](std::string_view, uint32_t size) {
+                wide = wide || size > 1;
+            });
+        }
+        return wide;
+    }
+
+    // Modifies a few nodes of the tree the way an application would between two frames:
+    // refills or extends blocks, changes their width and appends new nodes to layouts.
+    void modify(Node& root, uint32_t seed) {
+        std::mt19937 engine {seed};
+        const auto next = [&engine](uint32_t n) {
+            return std::uniform_int_distribution<uint32_t> {0, n - 1}(engine);
+        };
+
+        std::vector<Block*> blocks;
+        std::vector<Container*> containers;
+        std::vector<Node*> stack {&root};
+        while (!stack.empty()) {
+            Node* node = stack.back();
+            stack.pop_back();
+            if (node->type == Node::Type::Block) {
+                blocks.push_back(static_cast<Block*>(node));
+            } else if (node->type == Node::Type::HLayout || node->type == Node::Type::VLayout) {
+                containers.push_back(static_cast<Container*>(node));
+                for (const auto& child : static_cast<Container*>(node)->children) {
+                    stack.push_back(child.get());
+                }
+            }
+        }
+
+        for (uint32_t i = 1 + next(3); i > 0; i--) {
+            uint32_t action = next(5);
+            if (action == 4 && !containers.empty()) {
+                Container& container = *containers[next(static_cast<uint32_t>(containers.size()))];
+                if (next(3) == 0) {
+                    container.add_node(make_divider("~"));
+                } else {
+                    container.add_node(make_random(seed + i));
+                }
+                continue;
+            }
+            if (blocks.empty()) {
+                continue;
+            }
+
+            Block& block = *blocks[next(static_cast<uint32_t>(blocks.size()))];
+            if (action == 0) {
+                block.clear();
+            }
+            if (action <= 2) {
+                // Blocks keep at least one line
+                for (uint32_t j = 1 + next(4); j > 0; j--) {
+                    block << std::string(next(12), static_cast<char>('a' + next(26))) << endl;
+                }
+            } else {
+                // As the random trees, only the blocks without wide characters are given a fixed width
+                block.width = next(2) && !has_wide(block) ? std::optional<uint32_t> {next(16)} : std::nullopt;
+                block.touch();
+            }
+        }
+    }
+
+    // Text displayed for the output of a presenter, as by Surface::text(): the escape sequences
+    // are removed and the rows are clipped or padded to the given number of columns
+    // (a wide character that does not fit in the last column is not displayed,
+    // a zero width character is displayed with the one before it, if any).
+    std::string visible_text(std::string_view output, uint32_t width) {
+        std::string text;
+        while (!output.empty()) {
+            size_t end = std::min(output.find('\n'), output.size());
+            uint32_t columns = 0;
+            bool clipped = false;
+            Text {output.substr(0, end)}.for_each([&](std::string_view token, uint32_t size) {
+                if (clipped || (size == 0 && (token[0] == '\033' || columns == 0))) {
+                    return;
+                }
+                clipped = size > width - columns;
+                if (!clipped) {
+                    text += token;
+                    columns += size;
+                }
+            });
+            text.append(width - columns, ' ');
+            if (end < output.size()) {
+                text += '\n';
+            }
+            output.remove_prefix(std::min(end + 1, output.size()));
+        }
+        return text;
+    }
+
+    // Random part of a frame of the given size, sometimes empty or larger than the frame.
+    Presenter::Viewport make_window(uint32_t width, uint32_t height, uint32_t seed) {
+        std::mt19937 engine {seed};
+        const auto next = [&engine](uint32_t n) {
+            return std::uniform_int_distribution<uint32_t> {0, n - 1}(engine);
+        };
+        Presenter::Viewport window;
+        window.width = next(8) == 0 ? UINT32_MAX : next(width + 3);
+        window.height = next(8) == 0 ? UINT32_MAX : next(height + 3);
+        window.x = next(width + 2);
+        window.y = next(height + 2);
+        return window;
+    }
+
+    // Text displayed for the part of the output (a frame of the given width) shown by the viewport,
+    // as visible_text() for its rows and columns: the columns of wide characters crossing its edges are spaces.
+    std::string visible_window(std::string_view output, uint32_t width, const Presenter::Viewport& viewport) {
+        uint32_t left = std::min(viewport.x, width);
+        uint32_t right = left + std::min(viewport.width, width - left);
+
+        std::string text;
+        // Character starting at each column of the row (none for the second column of a wide one)
+        std::vector<std::string_view> cells;
+        for (uint32_t y = 0; !output.empty(); y++) {
+            size_t end = std::min(output.find('\n'), output.size());
+            std::string_view line = output.substr(0, end);
+            output.remove_prefix(std::min(end + 1, output.size()));
+            if (y < viewport.y || y - viewport.y >= viewport.height) {
+                continue;
+            }
+
+            cells.clear();
+            const Text row {line};
+            row.for_each([&cells](std::string_view token, uint32_t size) {
+                if (size > 0) {
+                    cells.push_back(token);
+                    cells.resize(cells.size() + size - 1);
+                }
+            });
+            for (uint32_t x = left; x < right; x++) {
+                std::string_view cell = x < cells.size() ? cells[x] : " ";
+                bool wide = x + 1 < cells.size() && cells[x + 1].empty();
+                if (cell.empty() ? x == left : wide && x + 1 == right) {
+                    text += ' ';
+                } else {
+                    text += cell;
+                }
+            }
+            text += '\n';
+        }
+        return text;
+    }
+
+    // Index of the first byte that differs.
+    size_t mismatch(std::string_view a, std::string_view b) {
+        return static_cast<size_t>(std::mismatch(a.begin(), a.end(), b.begin(), b.end()).first - a.begin());
+    }
+
+    // Compares the tokens of each text with the expected ones, then checks that a lone ESC
+    // does not hide the end of a line from a block and that a number is padded to any width.
+    // Returns the number of mismatches.
+    uint32_t check_texts() {
+        uint32_t mismatches = 0;
+        for (const auto& t : Texts) {
+            std::string tokens;
+            Text {t.text}.for_each([&tokens](std::string_view token, uint32_t size) {
+                tokens += tokens.empty() ? "" : " ";
+                tokens += token;
+                tokens += ':' + std::to_string(size);
+            });
+            if (tokens != t.tokens) {
+                mismatches++;
+                std::printf("mismatch: tokens of text %zu: %zu bytes instead of %zu\n",
+                            static_cast<size_t>(&t - Texts), tokens.size(), std::strlen(t.tokens));
+            }
+        }
+
+        const Text text {"a\033\nb"};
+        auto block = make_block();
+        *block << text;
+        if (block->lines.size() != 2) {
+            mismatches++;
+            std::printf("mismatch: lone ESC: %zu lines instead of 2\n", block->lines.size());
+        }
+
+        // Numbers padded to any width
+        Text number;
+        number += Number {42, true, 10, 255};
+        std::string padded = std::string(252, ' ') + "-42";
+        if (number.str() != padded) {
+            mismatches++;
+            std::printf("mismatch: padded number: %zu bytes instead of %zu\n", number.str().size(), padded.size());
+        }
+        return mismatches;
+    }
+
+    // Presents each case with Presenter and the reference (a copy made of blocks), then compares them.
+    // Returns the number of mismatches.
+    uint32_t check_cases() {
+        uint32_t mismatches = 0;
+        for (const auto& c : Cases) {
+            auto root = c.make();
+            std::ostringstream os;
+            ReferencePresenter {os}.present(*as_blocks(*root));
+
+            const auto compare = [&](std::string_view expected, std::string_view output) {
+                if (output != expected) {
+                    mismatches++;
+                    std::printf("mismatch: case %s: byte %zu differs (%zu bytes instead of %zu)\n", c.name,
+                                mismatch(expected, output), output.size(), expected.size());
+                }
+            };
+
+            for (auto mode : {Presenter::Mode::Immediate, Presenter::Mode::Retained}) {
+                std::string output;
+                StringSink sink {output};
+                Presenter {sink, mode}.present(*root);
+                compare(os.str(), output);
+            }
+
+            // The styles are written differently: only the text displayed is compared
+            std::string output;
+            StringSink sink {output};
+            Surface surface;
+            Presenter {sink}.render(*root, surface);
+            compare(visible_text(os.str(), surface.width), surface.text());
+
+            Presenter presenter {sink};
+            presenter.set_minimal_sgr(true);
+            presenter.present(*root);
+            compare(visible_text(os.str(), surface.width), visible_text(output, surface.width));
+        }
+        std::printf("%zu cases compared, %u mismatches\n", sizeof(Cases) / sizeof(Cases[0]), mismatches);
+        return mismatches;
+    }
+
+    // Presents each tree of Outputs and compares its output with the expected one.
+    // Returns the number of mismatches.
+    uint32_t check_outputs() {
+        uint32_t mismatches = 0;
+        for (const auto& o : Outputs) {
+            auto root = o.make();
+            for (auto mode : {Presenter::Mode::Immediate, Presenter::Mode::Retained}) {
+                std::string output;
+                StringSink sink {output};
+                Presenter presenter {sink, mode};
+                presenter.set_minimal_sgr(o.minimal_sgr);
+                presenter.present(*root);
+                if (output != o.output) {
+                    mismatches++;
+                    std::printf("mismatch: output %s: byte %zu differs (%zu bytes instead of %zu)\n", o.name,
+                                mismatch(o.output, output), output.size(), std::strlen(o.output));
+                }
+            }
+        }
+        std::printf("%zu outputs compared, %u mismatches\n", sizeof(Outputs) / sizeof(Outputs[0]), mismatches);
+        return mismatches;
+    }
+
+    // Prints the time per frame of the reference and of the presenter, each presenting the tree for MinTime.
+    void compare_speed(const char* name, const Node& root, Presenter::Mode mode) {
+        constexpr std::chrono::milliseconds MinTime {100};
+
+        std::ostringstream os;
+        ReferencePresenter reference {os};
+        uint64_t reference_frames = 0;
+        auto start = Clock::now();
+        do {
+            os.str({});
+            reference.present(root);
+            reference_frames++;
+        } while (Clock::now() - start < MinTime);
+        double reference_ns = static_cast<double>(elapsed_ns(start)) / static_cast<double>(reference_frames);
+
+        std::string output;
+        StringSink sink {output};
+        Presenter presenter {sink, mode};
+        uint64_t frames = 0;
+        start = Clock::now();
+        do {
+            output.clear();
+            presenter.present(root);
+            frames++;
+        } while (Clock::now() - start < MinTime);
+        double ns = static_cast<double>(elapsed_ns(start)) / static_cast<double>(frames);
+
+        std::printf("%-32s %16.1f %16.1f %10.2fx%s\n", name, reference_ns, ns, reference_ns / ns,
+                    output == os.str() ? "" : "  MISMATCH");
+    }
+} // namespace
+
+bool run_differential(uint32_t trees) {
+    uint64_t reference_ns = 0;
+    uint64_t ns[ConfigurationCount] {};
+    uint64_t compared = 0;
+    uint32_t mismatches = check_texts() + check_cases() + check_outputs();
+
+    for (uint32_t seed = 0; seed < trees; seed++) {
+        // Some trees are tall enough to be presented in bands by the "threads" configuration
+        auto root = seed % 8 == 7 ? make_random_tall(seed) : make_random(seed);
+
+        std::vector<std::unique_ptr<Candidate>> candidates;
+        for (const auto& configuration : Configurations) {
+            candidates.push_back(std::make_unique<Candidate>(configuration));
+        }
+
+        for (uint32_t frame = 0; frame < Frames; frame++) {
+            if (frame > 0) {
+                modify(*root, seed * Frames + frame);
+            }
+
+            std::string reference = present_reference(*as_blocks(*root), reference_ns);
+            // Size of the frame, as laid out by the presenter
+            Layout layout;
+            layout.update(*root, false);
+            uint32_t width = layout.boxes[0].width;
+            Presenter::Viewport window = make_window(width, layout.rows(), seed * Frames + frame);
+
+            for (uint32_t k = 0; k < ConfigurationCount; k++) {
+                Candidate& candidate = *candidates[k];
+                candidate.output.clear();
+                if (Configurations[k].window) {
+                    candidate.presenter.set_viewport(window);
+                }
+                auto start = Clock::now();
+                if (Configurations[k].surface) {
+                    candidate.presenter.render(*root, candidate.surface);
+                } else if (Configurations[k].builder) {
+                    candidate.builder.reset();
+                    build(candidate.builder, *root);
+                    candidate.presenter.present(candidate.builder);
+                } else {
+                    candidate.presenter.present(*root);
+                }
+                ns[k] += elapsed_ns(start);
+                compared++;
+
+                std::string_view expected = reference;
+                std::string text;
+                if (Configurations[k].window) {
+                    text = visible_window(reference, width, window);
+                    expected = text;
+                    if (Configurations[k].surface) {
+                        candidate.surface.append_text(candidate.output);
+                    } else {
+                        uint32_t columns = std::min(window.width, width - std::min(window.x, width));
+                        candidate.output = visible_text(candidate.output, columns);
+                    }
+                } else if (Configurations[k].surface) {
+                    text = visible_text(reference, candidate.surface.width);
+                    expected = text;
+                    candidate.surface.append_text(candidate.output);
+                }
+
+                if (candidate.output != expected && mismatches++ < 10) {
+                    std::printf("mismatch: tree %u, frame %u, %s: byte %zu differs (%zu bytes instead of %zu)\n", seed,
+                                frame, Configurations[k].name, mismatch(expected, candidate.output),
+                                candidate.output.size(), expected.size());
+                }
+            }
+        }
+    }
+
+    std::printf("%u trees, %llu frames compared, %u mismatches\n\n", trees, static_cast<unsigned long long>(compared),
+                mismatches);
+
+    // Mean times per frame, then the ones of the synthetic trees
+    std::printf("%-32s %16s %16s %11s\n", "frames", "reference ns", "presenter ns", "speedup");
+    double frames = static_cast<double>(trees) * Frames;
+    for (uint32_t k = 0; k < ConfigurationCount; k++) {
+        std::string name = std::string {"random/"} + Configurations[k].name;
+        double speedup = static_cast<double>(reference_ns) / static_cast<double>(ns[k]);
+        std::printf("%-32s %16.1f %16.1f %10.2fx\n", name.c_str(), static_cast<double>(reference_ns) / frames,
+                    static_cast<double>(ns[k]) / frames, speedup);
+    }
+
+    compare_speed("wide/1000/immediate", *make_wide(1000), Presenter::Mode::Immediate);
+    compare_speed("wide/1000/retained", *make_wide(1000), Presenter::Mode::Retained);
+    compare_speed("tall/1000/immediate", *make_tall(1000), Presenter::Mode::Immediate);
+    compare_speed("tall/1000/retained", *make_tall(1000), Presenter::Mode::Retained);
+    compare_speed("deep/1000/immediate", *make_deep(1000), Presenter::Mode::Immediate);
+    compare_speed("deep/1000/retained", *make_deep(1000), Presenter::Mode::Retained);
+    compare_speed("debugger/immediate", *make_debugger(), Presenter::Mode::Immediate);
+    compare_speed("debugger/retained", *make_debugger(), Presenter::Mode::Retained);
+
+    return mismatches == 0;
+}
+} // namespace Tui::Benchmark
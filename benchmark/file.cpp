@@ -0,0 +1,161 @@
+#include "benchmark.h"
+#include "tui/block.h"
+#include "tui/factory.h"
+#include "tui/fileblock.h"
+#include "tui/format.h"
+#include "tui/presenter.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+// Temporary file, removed when destroyed.
+struct TemporaryFile {
+    explicit TemporaryFile(std::string_view bytes = {}) {
+        path = (std::filesystem::temp_directory_path() / "tui-benchmark-XXXXXX").string();
+        fd = ::mkstemp(path.data());
+        write(bytes);
+    }
+
+    ~TemporaryFile() {
+        ::close(fd);
+        ::unlink(path.c_str());
+    }
+
+    TemporaryFile(const TemporaryFile&) = delete;
+    TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+    void write(std::string_view bytes) const {
+        while (!bytes.empty()) {
+            ssize_t n = ::write(fd, bytes.data(), bytes.size());
+            if (n <= 0) {
+                return;
+            }
+            bytes.remove_prefix(static_cast<size_t>(n));
+        }
+    }
+
+    void truncate() const {
+        if (::ftruncate(fd, 0) == 0) {
+            ::lseek(fd, 0, SEEK_SET);
+        }
+    }
+
+    std::string path;
+    int fd;
+};
+
+// Lines of a disassembly dump.
+std::string& disassembly(std::string& out, uint32_t first, uint32_t count) {
+    Text line;
+    for (uint32_t i = first; i < first + count; i++) {
+        line.clear();
+        line += fmt("  {:08x}:\t48 89 e5 {:02x}          mov    %rsp,%rbp", 0x401000 + i * 4, i % 256);
+        out += line.view();
+        out += '\n';
+    }
+    return out;
+}
+
+// Dump of 200000 lines (about 11 MB).
+const TemporaryFile& dump() {
+    std::string bytes;
+    static const TemporaryFile file {disassembly(bytes, 0, 200000)};
+    return file;
+}
+
+uint64_t file_size(const std::string& path) {
+    return static_cast<uint64_t>(std::filesystem::file_size(path));
+}
+
+void file_block_read(State& state) {
+    // The file read into a block line by line
+    const auto& file = dump();
+    state.items_per_iteration = file_size(file.path);
+    for ([[maybe_unused]] auto _ : state) {
+        Block block;
+        std::ifstream is {file.path};
+        std::string line;
+        while (std::getline(is, line)) {
+            block << line << endl;
+        }
+        do_not_optimize(block);
+    }
+}
+
+void file_open(State& state) {
+    // The file mapped and indexed
+    const auto& file = dump();
+    state.items_per_iteration = file_size(file.path);
+    for ([[maybe_unused]] auto _ : state) {
+        FileBlock block;
+        block.open(file.path);
+        block.index();
+        do_not_optimize(block);
+    }
+}
+
+// Terminal sized view of the dump, scrolled by a line at each frame.
+void file_present(State& state) {
+    auto block = make_file_block(80);
+    block->open(dump().path);
+    block->index();
+    block->height = 40;
+
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+    presenter.present(*block);
+    state.items_per_iteration = *block->height;
+    state.output_bytes_per_iteration = buffer.size();
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        block->offset = (block->offset + 1) % block->count();
+        block->touch();
+        buffer.clear();
+        presenter.present(*block);
+    }
+}
+
+// Growing file followed as by tail -f: 100 lines are appended before each frame
+// (the file is truncated every 100000 lines, then opened again).
+void file_follow(State& state) {
+    TemporaryFile file;
+    auto block = make_file_block(80);
+    block->open(file.path);
+    block->height = 40;
+    block->tail = true;
+
+    std::string bytes;
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+    state.items_per_iteration = 100;
+
+    uint32_t i = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        if (i % 100000 == 0) {
+            file.truncate();
+            block->open(file.path);
+        }
+        bytes.clear();
+        file.write(disassembly(bytes, i, 100));
+        i += 100;
+
+        block->update();
+        buffer.clear();
+        presenter.present(*block);
+    }
+}
+} // namespace
+
+BENCHMARK(file_block_read, "file/block/read")
+BENCHMARK(file_open, "file/open")
+BENCHMARK(file_present, "file/present")
+BENCHMARK(file_follow, "file/follow")
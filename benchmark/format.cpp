@@ -0,0 +1,119 @@
+#include "benchmark.h"
+#include "tui/block.h"
+#include "tui/format.h"
+#include <iomanip>
+#include <sstream>
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+// Memory pane of a debugger: 16 rows of an address and 16 bytes
+constexpr uint32_t Rows = 16;
+
+void format_stringstream(State& state) {
+    // Hexadecimal formatted by the application before being appended
+    Block block;
+    state.items_per_iteration = Rows * 17;
+    for ([[maybe_unused]] auto _ : state) {
+        block.clear();
+        for (uint32_t i = 0; i < Rows; i++) {
+            std::ostringstream os;
+            os << std::hex << std::uppercase << std::setfill('0') << std::setw(4) << 0xC000 + i * 16 << ":";
+            for (uint32_t j = 0; j < 16; j++) {
+                os << " " << std::setw(2) << (i * 16 + j) % 256;
+            }
+            block << os.str() << endl;
+        }
+        do_not_optimize(block);
+    }
+}
+
+void format_hex(State& state) {
+    Block block;
+    state.items_per_iteration = Rows * 17;
+    for (uint32_t k = 0; k < 2; k++) {
+        block.clear();
+        for (uint32_t i = 0; i < Rows; i++) {
+            block << hex<4>(0xC000 + i * 16) << ":";
+            for (uint32_t j = 0; j < 16; j++) {
+                block << " " << hex<2>((i * 16 + j) % 256);
+            }
+            block << endl;
+        }
+    }
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        block.clear();
+        for (uint32_t i = 0; i < Rows; i++) {
+            block << hex<4>(0xC000 + i * 16) << ":";
+            for (uint32_t j = 0; j < 16; j++) {
+                block << " " << hex<2>((i * 16 + j) % 256);
+            }
+            block << endl;
+        }
+        do_not_optimize(block);
+    }
+}
+
+void format_fmt(State& state) {
+    Block block;
+    state.items_per_iteration = Rows * 3;
+    for (uint32_t k = 0; k < 2; k++) {
+        block.clear();
+        for (uint32_t i = 0; i < Rows; i++) {
+            block << fmt("{:04X}: {:08b} {:6}", 0xC000 + i * 16, i, i * 1000) << endl;
+        }
+    }
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        block.clear();
+        for (uint32_t i = 0; i < Rows; i++) {
+            block << fmt("{:04X}: {:08b} {:6}", 0xC000 + i * 16, i, i * 1000) << endl;
+        }
+        do_not_optimize(block);
+    }
+}
+
+// The same, with the format parsed at compile time.
+void format_fmt_checked(State& state) {
+    Block block;
+    state.items_per_iteration = Rows * 3;
+    for (uint32_t k = 0; k < 2; k++) {
+        block.clear();
+        for (uint32_t i = 0; i < Rows; i++) {
+            block << TUI_FMT("{:04X}: {:08b} {:6}", 0xC000 + i * 16, i, i * 1000) << endl;
+        }
+    }
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        block.clear();
+        for (uint32_t i = 0; i < Rows; i++) {
+            block << TUI_FMT("{:04X}: {:08b} {:6}", 0xC000 + i * 16, i, i * 1000) << endl;
+        }
+        do_not_optimize(block);
+    }
+}
+
+void format_decimal(State& state) {
+    // Integers appended to a text, as by Text {i}
+    Text text;
+    state.items_per_iteration = 100;
+    for ([[maybe_unused]] auto _ : state) {
+        text.clear();
+        for (uint32_t i = 0; i < 100; i++) {
+            text += dec<6>(i * 7919);
+        }
+        do_not_optimize(text);
+    }
+}
+} // namespace
+
+BENCHMARK(format_stringstream, "format/stringstream")
+BENCHMARK(format_hex, "format/hex")
+BENCHMARK(format_fmt, "format/fmt")
+BENCHMARK(format_fmt_checked, "format/fmt/checked")
+BENCHMARK(format_decimal, "format/decimal")
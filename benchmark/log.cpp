@@ -0,0 +1,146 @@
+#include "benchmark.h"
+#include "tui/block.h"
+#include "tui/factory.h"
+#include "tui/format.h"
+#include "tui/logblock.h"
+#include "tui/presenter.h"
+#include "tui/vlayout.h"
+#include <atomic>
+#include <thread>
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+// CPU trace lines appended between two frames, and lines kept by the log blocks.
+constexpr uint32_t Lines = 1000;
+constexpr uint32_t Capacity = 1024;
+
+template <typename Out>
+void trace(Out& out, uint32_t i) {
+    out << fmt("{:04X}: {:02X} {:02X}  ld a, {:02X}", 0xC000 + i % 0x4000, i % 256, (i * 7) % 256, (i * 13) % 256)
+        << endl;
+}
+
+void log_block_append(State& state) {
+    // All the lines are kept by a block, although only the last ones are presented
+    Block block;
+    state.items_per_iteration = Lines;
+    uint32_t i = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        for (uint32_t j = 0; j < Lines; j++) {
+            trace(block, i++);
+        }
+        do_not_optimize(block);
+    }
+}
+
+void log_append(State& state) {
+    LogBlock log {Capacity};
+    uint32_t i = 0;
+    for (; i < 2 * Capacity; i++) {
+        trace(log, i);
+    }
+    state.items_per_iteration = Lines;
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (uint32_t j = 0; j < Lines; j++) {
+            trace(log, i++);
+        }
+        do_not_optimize(log);
+    }
+}
+
+// Trace pane of a debugger: the last 40 lines, below a title, presented after each batch of lines.
+void log_present(State& state) {
+    auto root = make_vertical_layout();
+    auto title = make_block(80);
+    title << "trace" << endl;
+    auto log = make_log_block(Capacity, 80);
+    log->height = 40;
+    LogBlock& trace_log = *log;
+    root->add_node(std::move(title));
+    root->add_node(std::move(log));
+
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+    uint32_t i = 0;
+    for (; i < 2 * Capacity; i++) {
+        trace(trace_log, i);
+    }
+    presenter.present(*root);
+    state.items_per_iteration = Lines;
+    state.output_bytes_per_iteration = buffer.size();
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (uint32_t j = 0; j < Lines; j++) {
+            trace(trace_log, i++);
+        }
+        buffer.clear();
+        presenter.present(*root);
+    }
+}
+
+// Lines pushed to a queue then drained into the log block, on the same thread.
+void log_queue(State& state) {
+    LogBlock log {Capacity};
+    LogQueue queue {Lines};
+    uint32_t i = 0;
+    for (uint32_t k = 0; k < 3 * Capacity / Lines; k++) {
+        for (uint32_t j = 0; j < Lines; j++, i++) {
+            queue.push(fmt("{:04X}: {:02X}", 0xC000 + i % 0x4000, i % 256));
+        }
+        queue.drain(log);
+    }
+    state.items_per_iteration = Lines;
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        for (uint32_t j = 0; j < Lines; j++, i++) {
+            queue.push(fmt("{:04X}: {:02X}", 0xC000 + i % 0x4000, i % 256));
+        }
+        queue.drain(log);
+        do_not_optimize(log);
+    }
+}
+
+// Lines pushed by the measured (producer) thread while another thread drains them and presents the log.
+// Lines are dropped if the presenting thread does not keep up: the producer never waits.
+void log_queue_threads(State& state) {
+    auto log = make_log_block(Capacity, 80);
+    log->height = 40;
+    LogQueue queue {4 * Lines};
+    std::atomic<bool> stop {};
+
+    std::thread presenting {[&] {
+        std::string buffer;
+        StringSink sink {buffer};
+        Presenter presenter {sink, Presenter::Mode::Retained};
+        while (!stop) {
+            queue.drain(*log);
+            buffer.clear();
+            presenter.present(*log);
+        }
+    }};
+
+    state.items_per_iteration = Lines;
+    uint32_t i = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        for (uint32_t j = 0; j < Lines; j++, i++) {
+            queue.push(fmt("{:04X}: {:02X}", 0xC000 + i % 0x4000, i % 256));
+        }
+    }
+
+    stop = true;
+    presenting.join();
+}
+} // namespace
+
+BENCHMARK(log_block_append, "log/block/append")
+BENCHMARK(log_append, "log/append")
+BENCHMARK(log_present, "log/present")
+BENCHMARK(log_queue, "log/queue")
+BENCHMARK(log_queue_threads, "log/queue/threads")
@@ -0,0 +1,93 @@
+#include "benchmark.h"
+#include "reference.h"
+#include "trees.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+/*
+ * Runs the microbenchmarks of the hot paths of the library
+ * and reports the time and the heap allocations per operation.
+ *
+ * Usage: tui-benchmark [--filter SUBSTRING] [--min-time MS] [--json FILE]
+ *        tui-benchmark --memory
+ *        tui-benchmark --differential TREES
+ *
+ * With --json, the results are also written one JSON object per line,
+ * so that the results of two builds can be compared with diff.
+ *
+ * With --memory, the memory held by the synthetic trees is reported instead.
+ *
+ * With --differential, the given number of random trees are presented, modified and
+ * presented again by the presenter in various configurations (see reference.h):
+ * the exit status is 1 if any output differs from the one of the reference presenter
+ * (or from the expected one, for the few trees the presenter presents differently).
+ * The speedups over the reference are then reported.
+ *
+ * The exit status is 1 if a benchmark expected to run without heap allocations
+ * (e.g. presenting an unchanged tree) allocated memory.
+ */
+
+using namespace Tui::Benchmark;
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string json;
+    std::chrono::milliseconds min_time {200};
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--filter") && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (!std::strcmp(argv[i], "--min-time") && i + 1 < argc) {
+            min_time = std::chrono::milliseconds {std::atoi(argv[++i])};
+        } else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) {
+            json = argv[++i];
+        } else if (!std::strcmp(argv[i], "--memory")) {
+            report_memory();
+            return 0;
+        } else if (!std::strcmp(argv[i], "--differential") && i + 1 < argc) {
+            return run_differential(static_cast<uint32_t>(std::atoi(argv[++i]))) ? 0 : 1;
+        } else {
+            std::fprintf(stderr,
+                         "usage: %s [--filter SUBSTRING] [--min-time MS] [--json FILE] | --memory"
+                         " | --differential TREES\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("%-40s %12s %14s %10s %12s %14s %10s\n", "benchmark", "iterations", "ns/op", "allocs/op", "bytes/op",
+                "items/s", "output/op");
+
+    auto results = run(filter, min_time);
+
+    bool failed = false;
+    for (const auto& r : results) {
+        std::printf("%-40s %12llu %14.1f %10.2f %12.1f %14.0f %10llu%s\n", r.name.c_str(),
+                    static_cast<unsigned long long>(r.iterations), r.ns_per_op, r.allocations_per_op, r.bytes_per_op,
+                    r.items_per_second, static_cast<unsigned long long>(r.output_bytes_per_op),
+                    r.failed ? "  FAILED: unexpected allocations" : "");
+        failed = failed || r.failed;
+    }
+
+    if (!json.empty()) {
+        std::ofstream os {json};
+        if (!os) {
+            std::fprintf(stderr, "cannot open %s\n", json.c_str());
+            return 1;
+        }
+        for (const auto& r : results) {
+            char line[512];
+            std::snprintf(line, sizeof(line),
+                          "{\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f, "
+                          "\"bytes_per_op\": %.1f, \"items_per_second\": %.0f, \"output_bytes_per_op\": %llu}\n",
+                          r.name.c_str(), static_cast<unsigned long long>(r.iterations), r.ns_per_op,
+                          r.allocations_per_op, r.bytes_per_op, r.items_per_second,
+                          static_cast<unsigned long long>(r.output_bytes_per_op));
+            os << line;
+        }
+    }
+
+    return failed ? 1 : 0;
+}
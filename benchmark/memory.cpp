@@ -0,0 +1,83 @@
+#include "trees.h"
+#include "tui/builder.h"
+#include "tui/container.h"
+#include "tui/divider.h"
+#include "tui/fileblock.h"
+#include "tui/logblock.h"
+#include "tui/virtualblock.h"
+#include <cstdio>
+#include <vector>
+
+namespace Tui::Benchmark {
+namespace {
+    void print(const char* tree, const char* part, const MemoryUsage& usage) {
+        std::printf("%-20s %-12s %8llu %10llu %12llu %12llu %12llu\n", tree, part,
+                    static_cast<unsigned long long>(usage.nodes), static_cast<unsigned long long>(usage.tokens),
+                    static_cast<unsigned long long>(usage.used), static_cast<unsigned long long>(usage.reserved),
+                    static_cast<unsigned long long>(usage.allocations));
+    }
+
+    // Prints the memory held by the content nodes of the tree, then by the containers.
+    void report(const char* name, const Node& root, const MemoryUsage& total) {
+        MemoryUsage blocks;
+        MemoryUsage dividers;
+
+        std::vector<const Node*> stack {&root};
+        while (!stack.empty()) {
+            const Node& node = *stack.back();
+            stack.pop_back();
+            if (node.type == Node::Type::Block) {
+                blocks += static_cast<const Block&>(node).memory_usage();
+            } else if (node.type == Node::Type::VirtualBlock) {
+                blocks += static_cast<const VirtualBlock&>(node).memory_usage();
+            } else if (node.type == Node::Type::LogBlock) {
+                blocks += static_cast<const LogBlock&>(node).memory_usage();
+            } else if (node.type == Node::Type::FileBlock) {
+                blocks += static_cast<const FileBlock&>(node).memory_usage();
+            } else if (node.type == Node::Type::Divider) {
+                dividers += static_cast<const Divider&>(node).memory_usage();
+            } else if (node.type != Node::Type::Flattened) {
+                for (const auto& child : static_cast<const Container&>(node).children) {
+                    stack.push_back(child.get());
+                }
+            }
+        }
+
+        MemoryUsage containers {total.used - blocks.used - dividers.used,
+                                total.reserved - blocks.reserved - dividers.reserved,
+                                total.allocations - blocks.allocations - dividers.allocations,
+                                total.tokens - blocks.tokens - dividers.tokens,
+                                total.nodes - blocks.nodes - dividers.nodes};
+
+        print(name, "blocks", blocks);
+        print(name, "dividers", dividers);
+        print(name, "containers", containers);
+        print(name, "total", total);
+    }
+
+    void report(const char* name, const Node& root) {
+        report(name, root, static_cast<const Container&>(root).memory_usage());
+    }
+} // namespace
+
+void report_memory() {
+    std::printf("%-20s %-12s %8s %10s %12s %12s %12s\n", "tree", "part", "nodes", "tokens", "used", "reserved",
+                "allocations");
+
+    report("wide/1000", *make_wide(1000));
+    report("tall/1000", *make_tall(1000));
+    report("deep/1000", *make_deep(1000));
+    report("deep/100000", *make_deep(100000));
+    report("debugger", *make_debugger());
+
+    // The nodes of a static layout are stored in place: only their texts are allocated
+    StaticDebugger debugger;
+    fill_debugger(debugger);
+    print("debugger/static", "total", debugger.memory_usage());
+
+    // The nodes of a builder are pooled: the ones of the frame are allocated by chunks
+    Builder builder;
+    build_debugger(builder);
+    print("debugger/builder", "total", builder.memory_usage());
+}
+} // namespace Tui::Benchmark
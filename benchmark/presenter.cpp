@@ -0,0 +1,272 @@
+#include "benchmark.h"
+#include "trees.h"
+#include "tui/builder.h"
+#include "tui/container.h"
+#include "tui/factory.h"
+#include "tui/presenter.h"
+#include "tui/virtualblock.h"
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+// Presents the same tree over and over: the frame is written to a string
+// that is cleared each time, so only the work of the presenter is measured.
+// Once warmed up, the presenter must reuse its memory: no allocation is expected.
+template <std::unique_ptr<Node> (*make)(uint32_t), uint32_t n, Presenter::Mode mode = Presenter::Mode::Immediate,
+          Presenter::Output output = Presenter::Output::Full, uint32_t threads = 1, bool minimal_sgr = false>
+void present(State& state) {
+    auto root = make(n);
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, mode};
+    presenter.set_output(output);
+    presenter.set_threads(threads);
+    presenter.set_minimal_sgr(minimal_sgr);
+
+    // Warm up (the diff output alternates between two frames)
+    presenter.present(*root);
+    buffer.clear();
+    presenter.present(*root);
+    state.items_per_iteration = count_nodes(*root);
+    state.output_bytes_per_iteration = buffer.size();
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        buffer.clear();
+        presenter.present(*root);
+    }
+}
+
+// Retained mode with one block modified before each frame.
+template <std::unique_ptr<Node> (*make)(uint32_t), uint32_t n>
+void present_touched(State& state) {
+    auto root = make(n);
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+
+    // Find the first block of the tree
+    Node* node = root.get();
+    while (node->type != Node::Type::Block) {
+        node = static_cast<Container*>(node)->children.front().get();
+    }
+    auto& block = static_cast<Block&>(*node);
+
+    presenter.present(*root);
+    state.items_per_iteration = count_nodes(*root);
+    state.expect_no_allocations = true;
+
+    uint32_t i = 0;
+    for ([[maybe_unused]] auto _ : state) {
+        block.lines.front() = Text {i++ % 10};
+        block.touch();
+        buffer.clear();
+        presenter.present(*root);
+    }
+}
+
+// Terminal sized viewport scrolled to the middle of a large tree.
+template <std::unique_ptr<Node> (*make)(uint32_t), uint32_t n>
+void present_viewport(State& state) {
+    auto root = make(n);
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+
+    presenter.present(*root);
+    buffer.clear();
+    presenter.set_viewport(Presenter::Viewport {80, 40, 0, 0});
+    presenter.present(*root);
+    state.items_per_iteration = count_nodes(*root);
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        buffer.clear();
+        presenter.present(*root);
+    }
+}
+
+// Memory view of 65536 addresses of which only 40 rows are presented.
+void present_virtual(State& state) {
+    auto view = make_virtual_block(65536, [](uint32_t i, Text& line) {
+        line += Text {i * 16};
+        line += Text {": 00 00 00 00 00 00 00 00"};
+    });
+    view->height = 40;
+
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+    presenter.present(*view);
+    // The provider allocates its own temporary texts
+    state.items_per_iteration = *view->height;
+
+    for ([[maybe_unused]] auto _ : state) {
+        view->offset = (view->offset + 1) % 65536;
+        view->touch();
+        buffer.clear();
+        presenter.present(*view);
+    }
+}
+
+// Debugger layout with a structure fixed at compile time, presented over and over.
+template <Presenter::Mode mode>
+void present_static(State& state) {
+    StaticDebugger debugger;
+    fill_debugger(debugger);
+
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, mode};
+    presenter.present(debugger);
+    state.output_bytes_per_iteration = buffer.size();
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        buffer.clear();
+        presenter.present(debugger);
+    }
+}
+
+// Debugger frames with their statistics collected, to measure the cost of the collection.
+void present_debugger_stats(State& state) {
+    auto root = Benchmark::make_debugger();
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink};
+    presenter.set_stats(true);
+    presenter.present(*root);
+    state.output_bytes_per_iteration = buffer.size();
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        buffer.clear();
+        presenter.present(*root);
+    }
+}
+
+// Whole debugger frames: the content of the panes is produced at each frame,
+// into a tree built for the frame...
+void present_debugger_frame(State& state) {
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink};
+
+    for ([[maybe_unused]] auto _ : state) {
+        auto root = Benchmark::make_debugger();
+        buffer.clear();
+        presenter.present(*root);
+    }
+}
+
+// ...or into the blocks of a static layout.
+void present_static_frame(State& state) {
+    StaticDebugger debugger;
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+
+    for ([[maybe_unused]] auto _ : state) {
+        fill_debugger(debugger);
+        buffer.clear();
+        presenter.present(debugger);
+    }
+}
+
+// ...or into the pooled nodes of a builder (the content allocates as the one of the static layout).
+void present_builder_frame(State& state) {
+    Builder builder;
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink, Presenter::Mode::Retained};
+
+    for ([[maybe_unused]] auto _ : state) {
+        build_debugger(builder);
+        buffer.clear();
+        presenter.present(builder);
+    }
+}
+
+// Debugger frames rendered into a surface instead of being written...
+void render_debugger(State& state) {
+    auto root = Benchmark::make_debugger();
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink};
+    Surface surface;
+    presenter.render(*root, surface);
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        presenter.render(*root, surface);
+        do_not_optimize(surface);
+    }
+}
+
+// ...then converted to plain text or to an ANSI stream.
+template <bool ansi>
+void render_debugger_convert(State& state) {
+    auto root = Benchmark::make_debugger();
+    std::string buffer;
+    StringSink sink {buffer};
+    Presenter presenter {sink};
+    Surface surface;
+    presenter.render(*root, surface);
+    std::string out;
+    if (ansi) {
+        surface.append_ansi(out);
+    } else {
+        surface.append_text(out);
+    }
+    state.output_bytes_per_iteration = out.size();
+    state.expect_no_allocations = true;
+
+    for ([[maybe_unused]] auto _ : state) {
+        out.clear();
+        if (ansi) {
+            surface.append_ansi(out);
+        } else {
+            surface.append_text(out);
+        }
+        do_not_optimize(out);
+    }
+}
+
+std::unique_ptr<Node> make_debugger(uint32_t) {
+    return Benchmark::make_debugger();
+}
+
+constexpr auto Retained = Presenter::Mode::Retained;
+constexpr auto Immediate = Presenter::Mode::Immediate;
+constexpr auto Full = Presenter::Output::Full;
+constexpr auto Diff = Presenter::Output::Diff;
+} // namespace
+
+BENCHMARK((present<make_wide, 1000>), "presenter/wide/1000")
+BENCHMARK((present<make_tall, 1000>), "presenter/tall/1000")
+BENCHMARK((present<make_deep, 1000>), "presenter/deep/1000")
+BENCHMARK((present<make_wide, 10000>), "presenter/wide/10000")
+BENCHMARK((present<make_tall, 10000>), "presenter/tall/10000")
+BENCHMARK((present<make_deep, 10000>), "presenter/deep/10000")
+BENCHMARK((present<make_deep, 1000, Retained>), "presenter/deep/1000/retained")
+BENCHMARK((present_touched<make_deep, 1000>), "presenter/deep/1000/retained_touched")
+BENCHMARK((present<make_deep, 1000, Immediate, Diff>), "presenter/deep/1000/diff")
+BENCHMARK((present<make_tall, 10000, Retained, Full, 4>), "presenter/tall/10000/retained/4_threads")
+BENCHMARK((present<make_deep, 10000, Retained, Full, 4>), "presenter/deep/10000/retained/4_threads")
+BENCHMARK((present<make_deep, 10000, Retained>), "presenter/deep/10000/retained")
+BENCHMARK((present_viewport<make_wide, 10000>), "presenter/wide/10000/viewport")
+BENCHMARK((present_viewport<make_tall, 10000>), "presenter/tall/10000/viewport")
+BENCHMARK((present_viewport<make_deep, 10000>), "presenter/deep/10000/viewport")
+BENCHMARK((present<make_debugger, 0>), "presenter/debugger")
+BENCHMARK((present<make_debugger, 0, Immediate, Full, 1, true>), "presenter/debugger/minimal_sgr")
+BENCHMARK((present_static<Immediate>), "presenter/debugger/static")
+BENCHMARK((present_static<Retained>), "presenter/debugger/static/retained")
+BENCHMARK(present_debugger_stats, "presenter/debugger/stats")
+BENCHMARK(present_debugger_frame, "presenter/debugger/frame")
+BENCHMARK(present_static_frame, "presenter/debugger/static/frame")
+BENCHMARK(present_builder_frame, "presenter/debugger/builder/frame")
+BENCHMARK(render_debugger, "presenter/debugger/surface")
+BENCHMARK(render_debugger_convert<false>, "presenter/debugger/surface/text")
+BENCHMARK(render_debugger_convert<true>, "presenter/debugger/surface/ansi")
+BENCHMARK(present_virtual, "presenter/virtual/65536")
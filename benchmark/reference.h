@@ -0,0 +1,32 @@
+#ifndef REFERENCE_H
+#define REFERENCE_H
+
+#include "tui/node.h"
+#include <cstdint>
+#include <ostream>
+
+namespace Tui::Benchmark {
+// Frozen copy of the original presentation algorithm, used as the reference
+// of the output of Presenter (Output::Full, without minimal SGR).
+// Each node is wrapped and the whole tree is walked again for every row:
+// it is slow but simple, and must not be optimized. It is not changed along with the presenter:
+// the behaviors of the presenter that differ from it are checked against expected outputs instead.
+// Supports the blocks (without height nor offset), the dividers and the layouts.
+class ReferencePresenter {
+public:
+    explicit ReferencePresenter(std::ostream& os);
+
+    void present(const Node& root_node);
+
+private:
+    std::ostream& os;
+};
+
+// Presents random trees with Presenter in various configurations and compares
+// the output byte for byte with the one of ReferencePresenter, then reports how
+// faster than the reference the presenter is.
+// Returns false if any output differs.
+bool run_differential(uint32_t trees);
+} // namespace Tui::Benchmark
+
+#endif // REFERENCE_H
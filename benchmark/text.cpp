@@ -0,0 +1,110 @@
+#include "benchmark.h"
+#include "tui/decorators.h"
+#include "tui/text.h"
+
+using namespace Tui;
+using namespace Tui::Benchmark;
+
+namespace {
+const char* const Line = "The quick brown fox jumps over the lazy dog, then runs back to its den again.";
+
+void text_construct(State& state) {
+    std::string line {Line};
+    state.items_per_iteration = line.size();
+    for ([[maybe_unused]] auto _ : state) {
+        Text text {line};
+        do_not_optimize(text);
+    }
+}
+
+void text_construct_short(State& state) {
+    for ([[maybe_unused]] auto _ : state) {
+        Text text {"leaf"};
+        do_not_optimize(text);
+    }
+}
+
+void text_construct_long(State& state) {
+    std::string line(4096, 'x');
+    state.items_per_iteration = line.size();
+    for ([[maybe_unused]] auto _ : state) {
+        Text text {line};
+        do_not_optimize(text);
+    }
+}
+
+void text_construct_colored(State& state) {
+    // Line of the colored output of an external tool
+    std::string line {"\033[33m  401000:\033[0m\t48 89 e5             \033[34mmov\033[0m    %rsp,%rbp"};
+    state.items_per_iteration = line.size();
+    for ([[maybe_unused]] auto _ : state) {
+        Text text {line};
+        do_not_optimize(text);
+    }
+}
+
+void text_construct_utf8(State& state) {
+    std::string line {"Größe: 12 MiB — 東京 → Zürich ✓"};
+    state.items_per_iteration = line.size();
+    for ([[maybe_unused]] auto _ : state) {
+        Text text {line};
+        do_not_optimize(text);
+    }
+}
+
+void text_concat(State& state) {
+    Text a {Line};
+    Text b {Line};
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(a + b);
+    }
+}
+
+void text_concat_decorated(State& state) {
+    Text a {red(Line)};
+    Text b {bold(Line)};
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(a + b);
+    }
+}
+
+void text_substr(State& state) {
+    Text text {Line};
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(text.substr(Text::RawIndex {10}, Text::Length {40}));
+    }
+}
+
+void text_substr_decorated(State& state) {
+    Text text {red("The quick brown fox") + Text {" jumps over "} + bold("the lazy dog")};
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(text.substr(Text::RawIndex {10}, Text::Length {30}));
+    }
+}
+
+void text_rpad(State& state) {
+    Text text {Line};
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(text.rpad(Text::Length {120}));
+    }
+}
+
+void text_find(State& state) {
+    Text text {Line};
+    for ([[maybe_unused]] auto _ : state) {
+        do_not_optimize(text.find('\n'));
+    }
+}
+} // namespace
+
+BENCHMARK(text_construct, "text/construct")
+BENCHMARK(text_construct_short, "text/construct_short")
+BENCHMARK(text_construct_long, "text/construct_long")
+BENCHMARK(text_construct_colored, "text/construct_colored")
+BENCHMARK(text_construct_utf8, "text/construct_utf8")
+BENCHMARK(text_concat, "text/concat")
+BENCHMARK(text_concat_decorated, "text/concat_decorated")
+BENCHMARK(text_substr, "text/substr")
+BENCHMARK(text_substr_decorated, "text/substr_decorated")
+BENCHMARK(text_rpad, "text/rpad")
+BENCHMARK(text_find, "text/find")
@@ -0,0 +1,332 @@
+#include "trees.h"
+#include "tui/decorators.h"
+#include "tui/divider.h"
+#include "tui/factory.h"
+#include "tui/hlayout.h"
+#include "tui/logblock.h"
+#include "tui/virtualblock.h"
+#include "tui/vlayout.h"
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace Tui::Benchmark {
+namespace {
+    std::unique_ptr<Node> make_deep(uint32_t n, bool horizontal) {
+        if (n <= 1)
+            return make_leaf(n);
+        std::unique_ptr<Container> c;
+        if (horizontal)
+            c = make_horizontal_layout();
+        else
+            c = make_vertical_layout();
+        c->add_node(make_deep(n / 2, !horizontal));
+        c->add_node(make_deep(n - n / 2, !horizontal));
+        return c;
+    }
+} // namespace
+
+std::unique_ptr<Block> make_leaf(uint32_t i) {
+    auto b {make_block()};
+    b << "leaf " << i << endl;
+    b << "0x" << i * 16 << endl;
+    return b;
+}
+
+std::unique_ptr<Node> make_wide(uint32_t n) {
+    auto h {make_horizontal_layout()};
+    for (uint32_t i = 0; i < n; i++) {
+        h->add_node(make_leaf(i));
+        if (i % 8 == 7)
+            h->add_node(make_divider("|"));
+    }
+    return h;
+}
+
+std::unique_ptr<Node> make_tall(uint32_t n) {
+    auto v {make_vertical_layout()};
+    for (uint32_t i = 0; i < n; i += 16) {
+        auto group {make_vertical_layout()};
+        for (uint32_t j = i; j < n && j < i + 16; j++) {
+            group->add_node(make_leaf(j));
+        }
+        v->add_node(std::move(group));
+        v->add_node(make_divider("-"));
+    }
+    return v;
+}
+
+std::unique_ptr<Node> make_deep(uint32_t n) {
+    return make_deep(n, true);
+}
+
+namespace {
+    void fill_registers(Block& block) {
+        block.clear();
+        static const char* const Registers[] = {"rax", "rbx", "rcx", "rdx", "rsi", "rdi", "rbp", "rsp",
+                                                "r8",  "r9",  "r10", "r11", "r12", "r13", "r14", "r15"};
+        for (uint32_t i = 0; i < 16; i++) {
+            block << bold(Registers[i]) << " "
+                  << (i % 5 == 0 ? red(Text {"0x"} + Text {i * 4099}) : Text {i * 4099}) << endl;
+        }
+    }
+
+    void fill_stack(Block& block) {
+        block.clear();
+        for (uint32_t i = 0; i < 16; i++) {
+            block << darkgray(Text {0x7ffc000 + i * 8}) << "  " << lightblue(Text {i * 977}) << endl;
+        }
+    }
+
+    void fill_disassembly(Block& block) {
+        block.clear();
+        static const char* const Mnemonics[] = {"mov", "push", "lea", "call", "cmp", "jne", "add", "ret"};
+        for (uint32_t i = 0; i < 24; i++) {
+            Text line = darkgray(Text {0x401000 + i * 3}) + Text {": "} + green("48 89 e5") + Text {"  "} +
+                        lightblue(Mnemonics[i % 8]) + Text {" "} + yellow("%rsp") + Text {","} + yellow("%rbp");
+            block << (i == 5 ? bold(std::move(line)) : line) << endl;
+        }
+    }
+
+    void fill_memory(Block& block) {
+        block.clear();
+        for (uint32_t i = 0; i < 12; i++) {
+            block << darkgray(Text {0x601000 + i * 16}) << ": ";
+            for (uint32_t j = 0; j < 16; j++) {
+                block << ((i + j) % 7 == 0 ? lightred("00") : Text {"ff"}) << " ";
+            }
+            block << endl;
+        }
+    }
+} // namespace
+
+std::unique_ptr<Node> make_debugger() {
+    auto registers {make_block()};
+    fill_registers(*registers);
+
+    auto stack {make_block()};
+    fill_stack(*stack);
+
+    auto disassembly {make_block(48)};
+    fill_disassembly(*disassembly);
+
+    auto memory {make_block()};
+    fill_memory(*memory);
+
+    auto left {make_vertical_layout()};
+    left->add_node(std::move(registers));
+    left->add_node(make_divider("-"));
+    left->add_node(std::move(stack));
+
+    auto right {make_vertical_layout()};
+    right->add_node(std::move(disassembly));
+    right->add_node(make_divider("-"));
+    right->add_node(std::move(memory));
+
+    auto root {make_horizontal_layout()};
+    root->add_node(std::move(left));
+    root->add_node(make_divider("|"));
+    root->add_node(std::move(right));
+    return root;
+}
+
+void fill_debugger(StaticDebugger& debugger) {
+    auto& left = debugger.get<0>();
+    auto& right = debugger.get<2>();
+    fill_registers(left.get<0>());
+    fill_stack(left.get<2>());
+    fill_disassembly(right.get<0>());
+    fill_memory(right.get<2>());
+}
+
+void build_debugger(Builder& builder) {
+    builder.reset();
+    builder.begin_horizontal_layout();
+
+    builder.begin_vertical_layout();
+    fill_registers(builder.block());
+    builder.divider("-");
+    fill_stack(builder.block());
+    builder.end_layout();
+
+    builder.divider("|");
+
+    builder.begin_vertical_layout();
+    fill_disassembly(builder.block(48));
+    builder.divider("-");
+    fill_memory(builder.block());
+    builder.end_layout();
+
+    builder.end_layout();
+}
+
+namespace {
+    class RandomTree {
+    public:
+        explicit RandomTree(uint32_t seed) :
+            engine {seed} {
+        }
+
+        uint32_t next(uint32_t n) {
+            return std::uniform_int_distribution<uint32_t> {0, n - 1}(engine);
+        }
+
+        // Word of ASCII, multi-byte and wide characters (at least the given number of them),
+        // sometimes ending with a new line. The wide characters are left out of the lines that can be cut
+        // (the ones of blocks with a fixed width, and of virtual and log blocks, 0 columns wide otherwise,
+        // as wide as their layout): the reference does not pad the ones cut (see Outputs in differential.cpp).
+        std::string word(bool wide, bool lines = true, uint32_t min = 0) {
+            static const char* const Characters[] = {"a", "b", "x", "y", "z", "0", "9", " ", ".",
+                                                     "\xc3\xa9", "\xe2\x94\x80", "\xe6\xbc\xa2"};
+            constexpr uint32_t Count = sizeof(Characters) / sizeof(Characters[0]);
+            std::string s;
+            for (uint32_t i = std::max(min, next(8)); i > 0; i--) {
+                s += Characters[next(wide ? Count : Count - 1)];
+            }
+            if (lines && next(6) == 0)
+                s += "\n";
+            return s;
+        }
+
+        std::optional<uint32_t> width() {
+            return next(3) == 0 ? std::optional<uint32_t> {next(10)} : std::nullopt;
+        }
+
+        // Text with nested decorators.
+        Text decorate(Text&& text, uint32_t depth = 0) {
+            switch (depth < 2 ? next(8) : 7) {
+            case 0:
+                return red(std::move(text));
+            case 1:
+                return color<200>(std::move(text));
+            case 2:
+                return bold(decorate(std::move(text), depth + 1));
+            case 3:
+                return bg_rgb<0x203040>(decorate(std::move(text), depth + 1));
+            case 4:
+                return lightgray(std::move(text));
+            default:
+                return std::move(text);
+            }
+        }
+
+        std::unique_ptr<Node> divider() {
+            // One column wide, so that they fill any width (see Outputs in differential.cpp for the others)
+            static const char* const Dividers[] = {"|", "=", "\xe2\x94\x80", "#"};
+            return make_divider(decorate(Text {Dividers[next(4)]}));
+        }
+
+        std::unique_ptr<Node> node(uint32_t depth) {
+            uint32_t kind = next(depth > 3 ? 2 : 5);
+            if (kind == 4 && depth > 0) {
+                return divider();
+            }
+            if (kind < 2 || depth > 4) {
+                switch (next(16)) {
+                case 0:
+                    // Block without lines
+                    return make_block(width());
+                case 1: {
+                    // Virtual block of a few lines (sometimes none), none of them empty:
+                    // the ending empty lines of a block are not presented, unlike the ones of a virtual block
+                    std::vector<Text> lines(next(6));
+                    for (auto& line : lines) {
+                        line = decorate(Text {word(false, false, 1)});
+                    }
+                    auto count = static_cast<uint32_t>(lines.size());
+                    return make_virtual_block(
+                        count, [lines](uint32_t index, Text& line) { line += lines[index]; }, width());
+                }
+                case 2: {
+                    // Log block, sometimes of more lines than it keeps (none of them empty, as above)
+                    auto log = make_log_block(1 + next(4), width());
+                    for (uint32_t i = next(8); i > 0; i--) {
+                        *log << decorate(Text {word(false, false, 1)});
+                        if (next(4))
+                            *log << endl;
+                    }
+                    return log;
+                }
+                default:
+                    break;
+                }
+
+                // Blocks have at least one line, sometimes a lot of them
+                auto b {make_block(width())};
+                for (uint32_t i = 1 + next(next(8) == 0 ? 100 : 5); i > 0; i--) {
+                    b << Text {};
+                    for (uint32_t j = next(3); j > 0; j--) {
+                        b << decorate(Text {word(!b->width)});
+                    }
+                    if (next(4))
+                        b << endl;
+                }
+                return b;
+            }
+            std::unique_ptr<Container> c;
+            if (kind == 2)
+                c = make_horizontal_layout();
+            else
+                c = make_vertical_layout();
+            for (uint32_t i = 1 + next(4); i > 0; i--) {
+                c->add_node(node(depth + 1));
+            }
+            return c;
+        }
+
+        // Vertical layout of sections separated by dividers, until the given number of rows at least:
+        // each section is a horizontal layout of random trees and tall blocks, sometimes separated by dividers.
+        std::unique_ptr<Node> tall(uint32_t rows) {
+            auto root {make_vertical_layout()};
+            for (uint32_t height = 0; height < rows;) {
+                auto section {make_horizontal_layout()};
+                uint32_t section_height = 0;
+                for (uint32_t i = 1 + next(3); i > 0; i--) {
+                    if (next(3) == 0) {
+                        section->add_node(node(2));
+                    } else {
+                        auto b {make_block(width())};
+                        uint32_t lines = 1 + next(200);
+                        for (uint32_t j = 0; j < lines; j++) {
+                            b << decorate(Text {word(!b->width, false)}) << endl;
+                        }
+                        section_height = std::max(section_height, lines);
+                        section->add_node(std::move(b));
+                    }
+                    if (next(2)) {
+                        section->add_node(divider());
+                    }
+                }
+                root->add_node(std::move(section));
+                root->add_node(divider());
+                height += section_height + 1;
+            }
+            return root;
+        }
+
+    private:
+        std::mt19937 engine;
+    };
+} // namespace
+
+std::unique_ptr<Node> make_random(uint32_t seed) {
+    return RandomTree {seed}.node(0);
+}
+
+std::unique_ptr<Node> make_random_tall(uint32_t seed) {
+    RandomTree tree {seed};
+    uint32_t rows = 128 + tree.next(873);
+    return tree.tall(rows);
+}
+
+uint32_t count_nodes(const Node& node) {
+    uint32_t n = 1;
+    if (node.type == Node::Type::HLayout || node.type == Node::Type::VLayout) {
+        for (const auto& child : static_cast<const Container&>(node).children) {
+            n += count_nodes(*child);
+        }
+    }
+    return n;
+}
+} // namespace Tui::Benchmark
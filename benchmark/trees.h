@@ -0,0 +1,52 @@
+#ifndef TREES_H
+#define TREES_H
+
+#include "tui/block.h"
+#include "tui/builder.h"
+#include "tui/node.h"
+#include "tui/static.h"
+#include <cstdint>
+#include <memory>
+
+namespace Tui::Benchmark {
+// Block with two short lines.
+std::unique_ptr<Block> make_leaf(uint32_t i);
+
+// N blocks side by side.
+std::unique_ptr<Node> make_wide(uint32_t n);
+
+// N blocks one below the other, grouped in vertical layouts of 16 blocks.
+std::unique_ptr<Node> make_tall(uint32_t n);
+
+// Binary tree of alternating horizontal and vertical layouts.
+std::unique_ptr<Node> make_deep(uint32_t n);
+
+// Debugger like layout: colored registers, disassembly, memory and stack panes.
+std::unique_ptr<Node> make_debugger();
+
+// The same layout, with a structure fixed at compile time.
+using StaticDebugger =
+    Static::HLayout<Static::VLayout<Static::Block<>, Static::Divider<'-'>, Static::Block<>>, Static::Divider<'|'>,
+                    Static::VLayout<Static::Block<48>, Static::Divider<'-'>, Static::Block<>>>;
+
+// Fills the blocks of the layout with the content of the debugger panes (replacing their lines).
+void fill_debugger(StaticDebugger& debugger);
+
+// Builds the same layout and content as a frame of the builder (reset first).
+void build_debugger(Builder& builder);
+
+// Random tree of blocks (of decorated texts), dividers and layouts, the same for a given seed.
+// Uses only the features supported by ReferencePresenter (see reference.h).
+std::unique_ptr<Node> make_random(uint32_t seed);
+
+// The same, at least 128 rows high (about 1000 at most), so that its rows are presented
+// in bands by a presenter on several threads (see Presenter::set_threads()).
+std::unique_ptr<Node> make_random_tall(uint32_t seed);
+
+uint32_t count_nodes(const Node& node);
+
+// Prints a breakdown of the memory held by the trees above.
+void report_memory();
+} // namespace Tui::Benchmark
+
+#endif // TREES_H
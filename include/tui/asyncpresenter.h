@@ -0,0 +1,78 @@
+#ifndef ASYNCPRESENTER_H
+#define ASYNCPRESENTER_H
+
+#include "node.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace Tui {
+class Presenter;
+
+// Presents the frames of a Presenter on a dedicated render thread,
+// so that the thread building the frames does not wait for the output.
+//
+// A submitted frame replaces the pending one (if any) without waiting:
+// the render thread always presents the newest frame, the superseded
+// ones are dropped.
+class AsyncPresenter {
+public:
+    // The presenter is used by the render thread only: it must be
+    // configured before, and not be used directly while this exists.
+    explicit AsyncPresenter(Presenter& presenter);
+
+    // Presents the pending frame (if any), then stops the render thread.
+    ~AsyncPresenter();
+
+    AsyncPresenter(const AsyncPresenter&) = delete;
+    AsyncPresenter& operator=(const AsyncPresenter&) = delete;
+
+    // Hands over a finished frame: an owned tree or a snapshot shared with the caller.
+    // The tree must not be modified once submitted.
+    // Must be called by a single thread at a time.
+    void submit(std::shared_ptr<const Node> root);
+
+    // Limits the number of frames presented per second (0, the default, for no limit).
+    // The frames submitted meanwhile are coalesced into the newest one.
+    void set_max_fps(uint32_t fps);
+
+    // Waits until the submitted frames have been presented (or dropped).
+    void wait();
+
+    // Number of frames presented and of frames dropped since they were superseded.
+    uint64_t presented() const;
+    uint64_t dropped() const;
+
+private:
+    struct Frame {
+        std::shared_ptr<const Node> root;
+    };
+
+    void render();
+    std::unique_ptr<Frame> take();
+
+    Presenter& presenter;
+
+    // Single-slot mailbox: the newest frame not presented yet.
+    std::atomic<Frame*> mailbox {};
+
+    std::atomic<uint64_t> submitted {};
+    std::atomic<uint64_t> presented_frames {};
+    std::atomic<uint64_t> dropped_frames {};
+    std::atomic<std::chrono::steady_clock::duration::rep> min_interval {};
+
+    // Used only to put the render thread to sleep while the mailbox is empty.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::atomic<bool> sleeping {};
+    bool stop {};
+
+    std::thread thread;
+};
+} // namespace Tui
+
+#endif // ASYNCPRESENTER_H
@@ -5,24 +5,68 @@
 #include "text.h"
 #include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
 
 namespace Tui {
 struct Block : Node {
     explicit Block(std::optional<uint32_t> width = std::nullopt);
 
+    // The text is split in lines by \n and appended to the block's lines
+    // directly, without intermediate texts.
     Block& operator<<(const Text& text);
+    // A single line appended to an empty line is swapped with it:
+    // text is then left empty, with the storage of the replaced line.
+    Block& operator<<(Text&& text);
+    Block& operator<<(std::string_view str);
+    Block& operator<<(const std::string& str);
+    Block& operator<<(const char* str);
     Block& operator<<(Block& (*manip)(Block&));
+    // Writes the characters of the number straight into the last line.
+    Block& operator<<(const Number& number);
+
+    // Formatted text (see format.h), split in lines by \n.
+    template <typename... Args>
+    Block& operator<<(const Formatted<Args...>& formatted) {
+        formatted.append_to(*this);
+        return *this;
+    }
+
+    // Reserves storage for the given number of lines.
+    void reserve(size_t count);
+
+    // Removes all the lines. Their storage is kept and reused by
+    // the lines appended afterwards, so that a block can be refilled
+    // at each frame without allocating.
+    void clear();
+
+    // Appends a new empty line.
+    void new_line();
+
+    // Memory held by the block and its lines (see MemoryUsage).
+    MemoryUsage memory_usage() const;
 
     std::vector<Text> lines;
     std::optional<uint32_t> width;
+    // Fixed number of rows (the lines from offset to the end otherwise).
+    std::optional<uint32_t> height;
+    // Index of the line presented at the first row.
+    uint32_t offset {};
+
+private:
+    // Lines removed by clear(), ready to be reused.
+    std::vector<Text> spare;
 };
 
 Block& endl(Block&);
 
 // Helpers for std::unique_ptr
-Block& operator<<(const std::unique_ptr<Block>& block, const Text& text);
+template <typename T>
+Block& operator<<(const std::unique_ptr<Block>& block, T&& value) {
+    return *block << std::forward<T>(value);
+}
 Block& operator<<(const std::unique_ptr<Block>& block, Block& (*manip)(const std::unique_ptr<Block>&));
 Block& endl(const std::unique_ptr<Block>&);
 } // namespace Tui
 
-#endif // BLOCK_H
\ No newline at end of file
+#endif // BLOCK_H
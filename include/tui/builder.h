@@ -0,0 +1,95 @@
+#ifndef BUILDER_H
+#define BUILDER_H
+
+#include "block.h"
+#include "divider.h"
+#include "layout.h"
+#include "memory.h"
+#include "node.h"
+#include "text.h"
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace Tui {
+// Tree built anew at each frame, in immediate mode, e.g.
+//
+//     builder.reset();
+//     builder.begin_horizontal_layout();
+//     builder.block(20) << "registers" << endl;
+//     builder.divider("|");
+//     builder.block() << "disassembly" << endl;
+//     builder.end_layout();
+//     presenter.present(builder);
+//
+// The nodes are not allocated one by one: they are taken from pools kept from frame to frame,
+// and reset() releases all of them at once in O(1). Only the nodes are pooled, there is no arena
+// for the texts: a pooled block keeps the storage of its lines (see Block::clear()), but the texts
+// appended to it (e.g. by decorators such as red()) are allocated as usual.
+//
+// The tree is stored flat, as structure of arrays indexed by the position of the nodes in pre-order,
+// so that its boxes are listed (see Layout::Flatten) without walking pointers. The builder and its
+// layouts are not Containers (see Node::Type::Flattened): the builder is presented as the root of a frame only.
+// The nodes added at the top level are laid out vertically, as the children of a VLayout.
+//
+// The whole frame is laid out at each present(), as in Presenter::Mode::Immediate, whatever the mode.
+class Builder : public Node {
+public:
+    Builder();
+
+    Builder(const Builder&) = delete;
+    Builder& operator=(const Builder&) = delete;
+
+    // Removes all the nodes, keeping them (and their storage) to be reused by the next frame.
+    // The references to the nodes of the frame are invalidated.
+    void reset();
+
+    // Starts a layout: the nodes added until the matching end_layout() are its children.
+    void begin_horizontal_layout();
+    void begin_vertical_layout();
+    void end_layout();
+
+    // Adds a block (without lines) or a divider. The node stays valid until reset().
+    Block& block(std::optional<uint32_t> width = std::nullopt);
+    Divider& divider(const Text& text);
+
+    // Adds a content node owned by the application, such as a LogBlock kept from frame to frame.
+    // The node must not be a layout.
+    void add(const Node& node);
+
+    // Number of nodes of the frame (the top-level layout aside).
+    uint32_t size() const;
+
+    // Lists the boxes of the frame built with the given builder (see Layout::update()).
+    // The boxes are listed again at each frame, since the structure may change between frames.
+    static void flatten(const Node& root, std::vector<Layout::Box>& boxes);
+
+    // Memory held by the builder, its nodes and the pooled ones (see MemoryUsage).
+    // The nodes added with add() are not accounted.
+    MemoryUsage memory_usage() const;
+
+private:
+    void push(const Node& node, Layout::Type::BoxType type);
+    void begin_layout(Layout::Type::BoxType type);
+
+    // Nodes of the frame, in pre-order: the node, its box type and the index after its last descendant
+    // (UINT32_MAX for a layout not ended yet).
+    std::vector<const Node*> nodes;
+    std::vector<Layout::Type::BoxType> types;
+    std::vector<uint32_t> ends;
+
+    // Index of each layout begun and not ended yet (the top-level one first).
+    std::vector<uint32_t> open;
+
+    // Pooled nodes: the first ones are used by the frame.
+    std::deque<Node> layouts;
+    std::deque<Block> blocks;
+    std::deque<Divider> dividers;
+    uint32_t used_layouts {};
+    uint32_t used_blocks {};
+    uint32_t used_dividers {};
+};
+} // namespace Tui
+
+#endif // BUILDER_H
@@ -0,0 +1,43 @@
+#ifndef CELL_H
+#define CELL_H
+
+#include "style.h"
+#include <array>
+#include <string_view>
+
+namespace Tui {
+struct Cell {
+    // UTF-8 bytes of the glyph, zero padded (at most 4 bytes are kept).
+    // A glyph wider than one column is followed by continuation cells,
+    // whose glyph is empty.
+    using Glyph = std::array<char, 4>;
+
+    static Glyph glyph_of(std::string_view str) {
+        Glyph g {};
+        for (size_t i = 0; i < g.size() && i < str.size(); i++) {
+            g[i] = str[i];
+        }
+        return g;
+    }
+
+    std::string_view glyph_str() const {
+        size_t n = 0;
+        while (n < glyph.size() && glyph[n]) {
+            n++;
+        }
+        return {glyph.data(), n};
+    }
+
+    bool operator==(const Cell& other) const {
+        return glyph == other.glyph && style == other.style;
+    }
+    bool operator!=(const Cell& other) const {
+        return !(*this == other);
+    }
+
+    Glyph glyph {' '};
+    Style style {};
+};
+} // namespace Tui
+
+#endif // CELL_H
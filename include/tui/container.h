@@ -1,6 +1,7 @@
 #ifndef CONTAINER_H
 #define CONTAINER_H
 
+#include "memory.h"
 #include "node.h"
 #include <memory>
 #include <vector>
@@ -11,6 +12,10 @@ struct Container : Node {
 
     void add_node(std::unique_ptr<Node>&& node);
 
+    // Memory held by the container and the whole tree below it (see MemoryUsage).
+    // Each child is a heap allocation of its own.
+    MemoryUsage memory_usage() const;
+
     std::vector<std::unique_ptr<Node>> children;
 };
 } // namespace Tui
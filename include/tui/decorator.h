@@ -1,6 +1,7 @@
 #ifndef DECORATOR_H
 #define DECORATOR_H
 
+#include "sgr.h"
 #include "text.h"
 
 namespace Tui {
@@ -8,9 +9,24 @@ struct Decorator : Text {
     template <typename T, typename = std::enable_if_t<std::negation_v<std::is_base_of<Text, std::decay_t<T>>>>>
     Decorator(T&& str) :
         Text {} {
-        tokens.emplace_back(std::forward<T>(str), 0);
-        length = 0;
+        append(std::string_view {str}, 0);
     }
 };
+
+// Decorates texts with an escape sequence known at compile time,
+// followed by a reset sequence.
+//
+//     constexpr Decoration Warning {PaletteSgr[208].view()};
+//     block << Warning("careful");
+//     Warning.append(line, "careful"); // no intermediate text
+struct Decoration {
+    std::string_view sequence;
+
+    Text operator()(const Text& text) const;
+
+    // Appends the decorated plain characters to the text.
+    // No allocation is performed once the text has enough capacity.
+    void append(Text& text, std::string_view str) const;
+};
 } // namespace Tui
-#endif // DECORATOR_H
\ No newline at end of file
+#endif // DECORATOR_H
@@ -15,6 +15,14 @@ Text attr(Text&& text, uint8_t code);
 
 Text bold(Text&& text);
 
+// 24-bit colors (0xRRGGBB), of the text or of its background.
+template <uint32_t color>
+Text rgb(Text&& text);
+Text rgb(Text&& text, uint32_t color);
+template <uint32_t color>
+Text bg_rgb(Text&& text);
+Text bg_rgb(Text&& text, uint32_t color);
+
 Text reset();
 
 Text red(Text&& text);
@@ -34,8 +42,37 @@ Text lightgray(Text&& text);
 Text lightestgray(Text&& text);
 Text darkgray(Text&& text);
 Text darkestgray(Text&& text);
+
+// Decorations of the helpers above, e.g. Red("error") is the same as red("error").
+template <uint8_t code>
+inline constexpr Decoration Color {PaletteSgr[code].view()};
+template <uint8_t code>
+inline constexpr Decoration Attr {AttrSgr[code].view()};
+template <uint32_t color>
+inline constexpr Decoration Rgb {RgbSgr<color>.view()};
+template <uint32_t color>
+inline constexpr Decoration BgRgb {BgRgbSgr<color>.view()};
+
+inline constexpr Decoration Bold {Attr<1>};
+inline constexpr Decoration Red {Attr<31>};
+inline constexpr Decoration LightRed {Color<9>};
+inline constexpr Decoration Green {Attr<32>};
+inline constexpr Decoration LightGreen {Color<10>};
+inline constexpr Decoration Yellow {Attr<33>};
+inline constexpr Decoration LightYellow {Color<11>};
+inline constexpr Decoration Blue {Attr<34>};
+inline constexpr Decoration LightBlue {Color<12>};
+inline constexpr Decoration Magenta {Attr<35>};
+inline constexpr Decoration LightMagenta {Color<13>};
+inline constexpr Decoration Cyan {Attr<36>};
+inline constexpr Decoration LightCyan {Color<14>};
+inline constexpr Decoration Gray {Color<244>};
+inline constexpr Decoration LightGray {Color<248>};
+inline constexpr Decoration LightestGray {Color<250>};
+inline constexpr Decoration DarkGray {Color<240>};
+inline constexpr Decoration DarkestGray {Color<238>};
 } // namespace Tui
 
 #include "decorators.tpp"
 
-#endif // DECORATORS_H
\ No newline at end of file
+#endif // DECORATORS_H
@@ -1,11 +1,21 @@
 namespace Tui {
 template <uint8_t code>
 Text color(Text&& text) {
-    return Decorator {"\033[38;5;" + std::to_string(code) + "m"} + text + Decorator{"\033[0m"};
+    return Color<code>(text);
 }
 
 template <uint8_t code>
 Text attr(Text&& text) {
-    return Decorator {"\033[" + std::to_string(code) + "m"} + text + Decorator{"\033[0m"};
+    return Attr<code>(text);
 }
-} // namespace Tui
\ No newline at end of file
+
+template <uint32_t color>
+Text rgb(Text&& text) {
+    return Rgb<color>(text);
+}
+
+template <uint32_t color>
+Text bg_rgb(Text&& text) {
+    return BgRgb<color>(text);
+}
+} // namespace Tui
@@ -1,6 +1,7 @@
 #ifndef DIVIDER_H
 #define DIVIDER_H
 
+#include "memory.h"
 #include "node.h"
 #include "text.h"
 
@@ -11,6 +12,18 @@ struct Divider : Node {
         text {std::move(text)} {
     }
 
+    // Memory held by the divider and its text (see MemoryUsage).
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage;
+        usage.add_object(sizeof(Divider));
+        usage.add_stored(text.memory_usage(), sizeof(Text));
+        usage.nodes = 1;
+        return usage;
+    }
+
+    // Repeated over the width of the divider, the last repetition truncated to it
+    // and followed by a reset sequence (so that a frame never overflows its width).
+    // A divider without text is blank.
     Text text;
 };
 } // namespace Tui
@@ -1,6 +1,7 @@
 #ifndef FACTORY_H
 #define FACTORY_H
 
+#include <functional>
 #include <memory>
 #include <optional>
 
@@ -9,12 +10,19 @@ struct Block;
 struct HLayout;
 struct VLayout;
 struct Divider;
-struct Text;
+struct FileBlock;
+struct LogBlock;
+struct VirtualBlock;
+class Text;
 
 std::unique_ptr<Block> make_block(std::optional<uint32_t> width = std::nullopt);
 std::unique_ptr<HLayout> make_horizontal_layout();
 std::unique_ptr<VLayout> make_vertical_layout();
 std::unique_ptr<Divider> make_divider(Text&& text);
+std::unique_ptr<VirtualBlock> make_virtual_block(uint32_t count, std::function<void(uint32_t, Text&)> provider,
+                                                 std::optional<uint32_t> width = std::nullopt);
+std::unique_ptr<LogBlock> make_log_block(uint32_t capacity, std::optional<uint32_t> width = std::nullopt);
+std::unique_ptr<FileBlock> make_file_block(std::optional<uint32_t> width = std::nullopt);
 } // namespace Tui
 
 #endif // FACTORY_H
\ No newline at end of file
@@ -0,0 +1,89 @@
+#ifndef FILEBLOCK_H
+#define FILEBLOCK_H
+
+#include "memory.h"
+#include "node.h"
+#include "text.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Tui {
+// Block presenting the lines of a file mapped in memory, instead of copying them into texts
+// (e.g. a disassembly dump or a trace log of hundreds of MB): the presenter only reads the
+// lines it presents, as slices of the mapping.
+//
+// The lines are known once indexed: the offsets of the newlines are searched incrementally
+// (see index()), so that a large file can be shown while it is being indexed.
+// A file that grows can be followed, as by tail -f (see update()).
+//
+// The file must only grow while it is mapped: as with any mapping, reading the lines of a file
+// truncated by another process (e.g. a rotated log) raises SIGBUS, and update() does not detect it
+// (the file could be truncated right after any check). A file truncated by the application itself
+// is to be opened again (see open()) before the block is presented.
+struct FileBlock : Node {
+    explicit FileBlock(std::optional<uint32_t> width = std::nullopt);
+    ~FileBlock() override;
+
+    FileBlock(const FileBlock&) = delete;
+    FileBlock& operator=(const FileBlock&) = delete;
+
+    // Maps the file, replacing the current one (if any), without indexing its lines.
+    // Returns false (with errno set) if it cannot be opened or mapped: the block is then empty.
+    bool open(const std::string& path);
+
+    // Unmaps the file: the block is then empty.
+    void close();
+
+    // Indexes the lines of the next bytes of the file (at most the given number),
+    // e.g. a few MB before each frame. Returns whether the whole file is indexed.
+    bool index(size_t bytes = SIZE_MAX);
+
+    // Maps the bytes appended to the file since it was opened or last updated,
+    // then indexes them as by index(). Returns whether the whole file is indexed.
+    bool update(size_t bytes = SIZE_MAX);
+
+    // Number of lines indexed. The last line of the file, if not ended by \n,
+    // is counted once the whole file is indexed.
+    uint32_t count() const;
+
+    // Bytes of the line at the given index (without its line ending), valid while the file is mapped.
+    std::string_view line(uint32_t index) const;
+
+    // Appends the line at the given index to the text.
+    void append_line(uint32_t index, Text& text) const;
+
+    // Memory held by the block and its index (see MemoryUsage): the mapping is not accounted.
+    MemoryUsage memory_usage() const;
+
+    // Fixed width. Otherwise the block has no width of its own, as a virtual block (see VirtualBlock::width).
+    std::optional<uint32_t> width;
+    // Fixed number of rows (the lines from offset to the end otherwise).
+    std::optional<uint32_t> height;
+    // Index of the line presented at the first row.
+    uint32_t offset {};
+    // Presents the last lines instead (the offset is ignored), e.g. to follow a growing file.
+    bool tail {};
+
+private:
+    // Maps at least the given number of bytes of the file.
+    bool map(size_t length);
+    void unmap();
+
+    int fd {-1};
+    const char* data {};
+    // Bytes of the file, and bytes mapped (beyond the end of the file to let it grow).
+    size_t size {};
+    size_t mapped {};
+
+    // Offset of the start of each line indexed, followed by the one of the next line.
+    std::vector<uint64_t> starts {0};
+    // Bytes searched for newlines.
+    size_t indexed {};
+};
+} // namespace Tui
+
+#endif // FILEBLOCK_H
@@ -0,0 +1,278 @@
+#ifndef FORMAT_H
+#define FORMAT_H
+
+#include "block.h"
+#include "number.h"
+#include "text.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Tui {
+namespace Detail {
+    // Not constexpr: reached while parsing a format in a constant expression,
+    // it makes the compilation fail (see Format).
+    inline void invalid_format() {
+    }
+
+    template <typename T>
+    struct Identity {
+        using type = T;
+    };
+
+    // Arguments written as numbers (characters are written as is).
+    template <typename T>
+    constexpr bool IsInteger =
+        std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char>;
+
+    // Replacement field of a format, and the number it writes (its value aside).
+    struct Field {
+        // Offsets of its opening brace and after its closing brace.
+        uint32_t begin {};
+        uint32_t end {};
+        Number number {};
+    };
+} // namespace Detail
+
+// Format of fmt(): a text with a replacement field for each argument.
+// - {} writes the argument: an integer (in decimal), a character, a string, a Text or a Number.
+// - {:W} pads it to W columns: integers are right aligned, the other arguments left aligned.
+// - {:0W} pads an integer with zeros.
+// - {:d}, {:x}, {:X} and {:b} write an integer in decimal, hexadecimal (lower or upper case)
+//   or binary, e.g. {:04X} (negative integers in two's complement but in decimal).
+// - {{ and }} write { and }.
+// The format is parsed by the constexpr constructor: a format declared constexpr (or given to TUI_FMT)
+// that is invalid, or whose fields do not match the types of the arguments, does not compile.
+// Otherwise it is parsed at each use, and an invalid format is written as is.
+template <typename... Args>
+class Format {
+public:
+    template <size_t N>
+    constexpr Format(const char (&format)[N]) :
+        Format {std::string_view {format, N - 1}} {
+    }
+
+    constexpr Format(std::string_view format) :
+        format {format} {
+        parse();
+    }
+
+    std::string_view format;
+    Detail::Field fields[sizeof...(Args) > 0 ? sizeof...(Args) : 1] {};
+    bool valid {};
+
+private:
+    constexpr void parse() {
+        constexpr bool Integer[] = {Detail::IsInteger<Args>..., false};
+        const auto size = static_cast<uint32_t>(format.size());
+        uint32_t k = 0;
+
+        for (uint32_t i = 0; i < size; i++) {
+            if (format[i] == '}') {
+                // Closing braces are escaped outside of the fields
+                if (i + 1 == size || format[i + 1] != '}')
+                    return Detail::invalid_format();
+                i++;
+                continue;
+            }
+            if (format[i] != '{')
+                continue;
+            if (i + 1 < size && format[i + 1] == '{') {
+                i++;
+                continue;
+            }
+            if (k == sizeof...(Args))
+                return Detail::invalid_format();
+
+            Detail::Field field {};
+            field.begin = i++;
+            if (i < size && format[i] == ':') {
+                i++;
+                if (i < size && format[i] == '0') {
+                    if (!Integer[k])
+                        return Detail::invalid_format();
+                    field.number.fill = '0';
+                    i++;
+                }
+                uint32_t width = 0;
+                for (; i < size && format[i] >= '0' && format[i] <= '9'; i++) {
+                    width = width * 10 + static_cast<uint32_t>(format[i] - '0');
+                    if (width > Number::MaxDigits)
+                        return Detail::invalid_format();
+                }
+                field.number.width = static_cast<uint8_t>(width);
+                if (i < size && format[i] != '}') {
+                    char type = format[i++];
+                    if (!Integer[k])
+                        return Detail::invalid_format();
+                    if (type == 'x' || type == 'X') {
+                        field.number.base = 16;
+                        field.number.upper = type == 'X';
+                    } else if (type == 'b') {
+                        field.number.base = 2;
+                    } else if (type != 'd') {
+                        return Detail::invalid_format();
+                    }
+                }
+            }
+            if (i == size || format[i] != '}')
+                return Detail::invalid_format();
+            field.end = i + 1;
+            fields[k++] = field;
+        }
+
+        if (k != sizeof...(Args))
+            return Detail::invalid_format();
+        valid = true;
+    }
+};
+
+// Text formatted by fmt(), written straight into a Text or into the lines of a Block.
+// It refers to the arguments: it is meant to be written right away.
+template <typename... Args>
+class Formatted {
+public:
+    Formatted(const Format<Args...>& format, const Args&... args) :
+        format {format},
+        args {args...} {
+    }
+
+    void append_to(Text& text) const {
+        write(text);
+    }
+
+    void append_to(Block& block) const {
+        write(block);
+    }
+
+private:
+    static void put(Text& text, std::string_view str) {
+        text.append(str);
+    }
+    static void put(Block& block, std::string_view str) {
+        block << str;
+    }
+    static void put(Text& text, const Number& number) {
+        text += number;
+    }
+    static void put(Block& block, const Number& number) {
+        block << number;
+    }
+    static void put(Text& text, const Text& value) {
+        text += value;
+    }
+    static void put(Block& block, const Text& value) {
+        block << value;
+    }
+
+    // Columns of the line being written.
+    static uint32_t columns(const Text& text) {
+        return text.size();
+    }
+    static uint32_t columns(const Block& block) {
+        return block.lines.empty() ? 0 : block.lines.back().size().value;
+    }
+
+    template <typename Out>
+    void write(Out& out) const {
+        if (!format.valid) {
+            put(out, format.format);
+            return;
+        }
+        uint32_t offset = 0;
+        write_fields(out, offset, std::index_sequence_for<Args...> {});
+        write_literal(out, offset, static_cast<uint32_t>(format.format.size()));
+    }
+
+    template <typename Out, size_t... I>
+    void write_fields(Out& out, uint32_t& offset, std::index_sequence<I...>) const {
+        ((write_literal(out, offset, format.fields[I].begin), offset = format.fields[I].end,
+          write_argument(out, format.fields[I], std::get<I>(args))),
+         ...);
+    }
+
+    template <typename Out>
+    void write_literal(Out& out, uint32_t begin, uint32_t end) const {
+        // Escaped braces are written once
+        for (uint32_t i = begin; i < end; i++) {
+            if (format.format[i] == '{' || format.format[i] == '}') {
+                put(out, format.format.substr(begin, i + 1 - begin));
+                begin = ++i + 1;
+            }
+        }
+        if (begin < end) {
+            put(out, format.format.substr(begin, end - begin));
+        }
+    }
+
+    template <typename Out, typename T>
+    static void write_argument(Out& out, const Detail::Field& field, const T& value) {
+        if constexpr (Detail::IsInteger<T>) {
+            Number number = field.number;
+            if (number.base == 10) {
+                Number decimal = Number::decimal(value);
+                number.value = decimal.value;
+                number.negative = decimal.negative;
+            } else {
+                number.value = Number::bits(value);
+            }
+            put(out, number);
+        } else if constexpr (std::is_same_v<T, Number>) {
+            Number number = value;
+            number.width = std::max(number.width, field.number.width);
+            put(out, number);
+        } else {
+            uint32_t start = columns(out);
+            if constexpr (std::is_same_v<T, char>) {
+                put(out, std::string_view {&value, 1});
+            } else if constexpr (std::is_base_of_v<Text, T>) {
+                put(out, static_cast<const Text&>(value));
+            } else {
+                static_assert(std::is_convertible_v<const T&, std::string_view>,
+                              "arguments are integers, characters, strings, texts or numbers");
+                put(out, std::string_view {value});
+            }
+
+            // Left aligned
+            constexpr std::string_view Spaces {"                "};
+            uint32_t end = columns(out);
+            uint32_t written = end - std::min(start, end);
+            for (uint32_t pad = field.number.width - std::min<uint32_t>(field.number.width, written); pad > 0;) {
+                auto n = std::min(pad, static_cast<uint32_t>(Spaces.size()));
+                put(out, Spaces.substr(0, n));
+                pad -= n;
+            }
+        }
+    }
+
+    Format<Args...> format;
+    std::tuple<const Args&...> args;
+};
+
+// Formats the arguments (see Format), e.g. block << fmt("{:04X}: {:08b}", pc, flags).
+// The format is parsed at run time, at each call: an invalid one is written as is
+// (see TUI_FMT to check it at compile time instead).
+template <typename... Args>
+Formatted<Args...> fmt(Format<typename Detail::Identity<Args>::type...> format, const Args&... args) {
+    return {format, args...};
+}
+
+namespace Detail {
+    // The format is given by a lambda: calling it needs no state, so it is a constant expression.
+    template <typename F, typename... Args>
+    Formatted<Args...> checked_fmt(F format_of, const Args&... args) {
+        constexpr Format<Args...> format {format_of()};
+        return {format, args...};
+    }
+} // namespace Detail
+} // namespace Tui
+
+// As fmt(), with a string literal format parsed at compile time: an invalid format, or one whose
+// fields do not match the types of the arguments, does not compile, e.g. TUI_FMT("{:04X}", pc).
+#define TUI_FMT(format, ...) ::Tui::Detail::checked_fmt([] { return ::std::string_view {format}; }, __VA_ARGS__)
+
+#endif // FORMAT_H
@@ -0,0 +1,123 @@
+#ifndef LAYOUT_H
+#define LAYOUT_H
+
+#include "memory.h"
+#include "node.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Tui {
+// Computes the position and the size of each node of a tree.
+//
+// The tree is flattened in a contiguous array of boxes (in pre-order),
+// then laid out with one bottom-up pass (measure) and one top-down pass (arrange).
+//
+// Rows are assigned to nodes as the Presenter presents them:
+// - the children of a horizontal layout are presented in parallel;
+// - the children of a vertical layout are presented sequentially:
+//   a child starts when the previous one has finished its content,
+//   the last child is presented until its vertical layout ends.
+// A content node (block, virtual, log or file block, or divider) is presented in the rows [top, bottom):
+// it shows its content in the rows [top, end_row) and fills its space afterwards.
+class Layout {
+public:
+    struct Type {
+        using BoxType = uint8_t;
+        static constexpr BoxType Block = 1 << 0;
+        static constexpr BoxType HLayout = 1 << 1;
+        static constexpr BoxType VLayout = 1 << 2;
+        static constexpr BoxType HDivider = 1 << 3;
+        static constexpr BoxType VDivider = 1 << 4;
+        static constexpr BoxType VirtualBlock = 1 << 5;
+        static constexpr BoxType LogBlock = 1 << 6;
+        static constexpr BoxType FileBlock = 1 << 7;
+
+        static constexpr BoxType Divider = HDivider | VDivider;
+        static constexpr BoxType Content = Block | Divider | VirtualBlock | LogBlock | FileBlock;
+        static constexpr BoxType Container = HLayout | VLayout;
+    };
+
+    struct Box {
+        const Node* node {};
+        Type::BoxType type {};
+
+        // Index of the box after the last descendant of this one.
+        uint32_t end {};
+
+        // Version of the node the box has been measured for.
+        uint64_t version {};
+        // Whether the node must be measured again.
+        bool dirty {true};
+        // Whether the children of the node must be arranged again.
+        bool pending {true};
+
+        // Measures (bottom-up).
+        // Dimensions of nodes with fixed size.
+        std::optional<uint32_t> measured_width {};
+        std::optional<uint32_t> measured_height {};
+        // Rows needed to present the content of the node if it starts at the first row.
+        uint32_t first_rows {};
+
+        // Arrangement (top-down).
+        // Dimensions propagated down to automatically sized nodes.
+        uint32_t auto_width {};
+        uint32_t height {};
+        // Position and width of the node once filled the space of its container.
+        uint32_t x {};
+        uint32_t width {};
+        uint32_t top {};
+        uint32_t bottom {};
+        uint32_t end_row {};
+        // Whether the node is part of the right most branch of the content.
+        bool ending {};
+    };
+
+    // Lists the boxes of a tree whose structure never changes, in pre-order
+    // (e.g. the ones of a static layout, see static.h).
+    using Flatten = void (*)(const Node& root, std::vector<Box>& boxes);
+
+    // Type of the box of a node, given its parent (which gives the direction of a divider).
+    static Type::BoxType box_type(const Node& node, const Node* parent);
+
+    // Lays out the tree rooted at the given node: build(), measure() and arrange().
+    void update(const Node& root, bool retained, Flatten flatten = nullptr);
+
+    // Lists the boxes of the tree, walking it or with flatten (if given).
+    // If retained is true, the boxes of the previous call are reused
+    // and only the nodes modified since then (see Node::touch()) will be measured again.
+    void build(const Node& root, bool retained, Flatten flatten = nullptr);
+
+    // Measures the nodes listed by build() (bottom-up).
+    void measure();
+
+    // Arranges the nodes in their containers (top-down).
+    void arrange();
+
+    // Number of nodes measured by the last measure().
+    uint32_t measured() const;
+
+    // Number of rows of the whole layout.
+    uint32_t rows() const;
+
+    // Memory held by the boxes and the lists of the layout (see MemoryUsage).
+    MemoryUsage memory_usage() const;
+
+    std::vector<Box> boxes;
+
+private:
+    bool sync(const Node& root);
+    void sync_versions();
+    void rebuild(const Node& root);
+
+    // Boxes to measure, in pre-order.
+    std::vector<uint32_t> dirty;
+
+    std::vector<uint32_t> stack;
+
+    // Function that listed the boxes (null if built by walking the tree).
+    Flatten flattened {};
+};
+} // namespace Tui
+
+#endif // LAYOUT_H
@@ -0,0 +1,168 @@
+#ifndef LOGBLOCK_H
+#define LOGBLOCK_H
+
+#include "memory.h"
+#include "node.h"
+#include "text.h"
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Tui {
+// Block keeping only the most recent lines appended to it (e.g. a trace log):
+// its lines are stored in a ring of a fixed capacity, the oldest line is
+// reused (with its storage) when a new one is started in a full ring.
+// Once each line of the ring has been used, appending does not allocate.
+//
+// The most recent lines are presented: all of them, or the last `height`
+// ones if the height is fixed. The last line is not presented while it is
+// empty (i.e. right after endl).
+struct LogBlock : Node {
+    explicit LogBlock(uint32_t capacity, std::optional<uint32_t> width = std::nullopt);
+
+    // The text is split in lines by \n and appended to the block's lines, as by Block.
+    LogBlock& operator<<(const Text& text);
+    // A single line appended to an empty line is swapped with it:
+    // text is then left empty, with the storage of the replaced line.
+    LogBlock& operator<<(Text&& text);
+    LogBlock& operator<<(std::string_view str);
+    LogBlock& operator<<(const std::string& str);
+    LogBlock& operator<<(const char* str);
+    LogBlock& operator<<(LogBlock& (*manip)(LogBlock&));
+    LogBlock& operator<<(const Number& number);
+
+    template <typename... Args>
+    LogBlock& operator<<(const Formatted<Args...>& formatted) {
+        formatted.append_to(back());
+        touch();
+        return *this;
+    }
+
+    // Removes all the lines, keeping their storage.
+    void clear();
+
+    // Starts a new empty line, reusing the oldest one if the ring is full.
+    void new_line();
+
+    // Maximum number of lines kept.
+    uint32_t capacity() const {
+        return static_cast<uint32_t>(ring.size());
+    }
+
+    // Number of lines kept.
+    uint32_t count() const {
+        return lines;
+    }
+
+    // Number of lines that can be presented: the last one is not while it is empty.
+    uint32_t presented() const {
+        return lines - (lines > 0 && line(lines - 1).count == 0 ? 1 : 0);
+    }
+
+    // Line at the given index, from the oldest kept one.
+    const Text& line(uint32_t index) const {
+        return ring[slot(index)];
+    }
+
+    // Number of lines removed from the ring to make room for new ones.
+    uint64_t discarded() const {
+        return discarded_lines;
+    }
+
+    // Memory held by the block and its lines (see MemoryUsage).
+    MemoryUsage memory_usage() const;
+
+    // Fixed width. Otherwise the block has no width of its own, as a virtual block (see VirtualBlock::width).
+    std::optional<uint32_t> width;
+    // Fixed number of rows, presenting the last lines (all the lines otherwise).
+    std::optional<uint32_t> height;
+
+private:
+    // Slot of the ring holding the line at the given index.
+    uint32_t slot(uint32_t index) const {
+        uint32_t s = first + index;
+        return s < ring.size() ? s : s - static_cast<uint32_t>(ring.size());
+    }
+
+    // Line being written (a new one if there is none).
+    Text& back();
+
+    std::vector<Text> ring;
+    // Slot of the oldest line and number of lines kept.
+    uint32_t first {};
+    uint32_t lines {};
+    uint64_t discarded_lines {};
+};
+
+LogBlock& endl(LogBlock&);
+
+// Lines handed over by a producer thread to the thread presenting a LogBlock,
+// through a lock-free single-producer single-consumer ring of lines.
+// Neither thread waits for the other: when the queue is full, the pushed
+// lines are dropped (and counted) instead of blocking the producer.
+// The lines are allocated once, then their storage is exchanged with the one
+// of the block's lines: once warm, neither side allocates.
+class LogQueue {
+public:
+    // The capacity is rounded up to a power of two.
+    explicit LogQueue(uint32_t capacity);
+
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+
+    // Producer thread: queues a line (split by \n when appended to the block).
+    // Returns false if the queue is full: the line is dropped.
+    bool push(std::string_view line);
+    bool push(const std::string& line);
+    bool push(const char* line);
+    bool push(const Text& line);
+
+    template <typename... Args>
+    bool push(const Formatted<Args...>& formatted) {
+        Text* line = acquire();
+        if (!line) {
+            return false;
+        }
+        formatted.append_to(*line);
+        publish();
+        return true;
+    }
+
+    // Consumer thread (the one presenting the block): appends the queued lines
+    // to the block, each followed by endl. Returns the number of lines appended.
+    uint32_t drain(LogBlock& block);
+
+    // Number of lines dropped because the queue was full.
+    uint64_t dropped() const;
+
+private:
+    // Empty line to write at the tail, or nullptr (counted as dropped) if the queue is full.
+    Text* acquire();
+    // Makes the line written at the tail available to the consumer.
+    void publish();
+
+    std::vector<Text> slots;
+    uint64_t mask;
+
+    // Lines pushed and lines drained so far, each written by a single thread:
+    // they are kept apart, along with the rest of the producer's state, to avoid false sharing.
+    alignas(64) std::atomic<uint64_t> tail {};
+    // Last head seen by the producer.
+    uint64_t cached_head {};
+    std::atomic<uint64_t> dropped_lines {};
+    alignas(64) std::atomic<uint64_t> head {};
+};
+
+// Helpers for std::unique_ptr
+template <typename T>
+LogBlock& operator<<(const std::unique_ptr<LogBlock>& block, T&& value) {
+    return *block << std::forward<T>(value);
+}
+LogBlock& operator<<(const std::unique_ptr<LogBlock>& block, LogBlock& (*manip)(const std::unique_ptr<LogBlock>&));
+LogBlock& endl(const std::unique_ptr<LogBlock>&);
+} // namespace Tui
+
+#endif // LOGBLOCK_H
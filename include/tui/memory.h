@@ -0,0 +1,74 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Tui {
+// Memory held by a text, a node or a tree of nodes (see the memory_usage() methods).
+// Objects are accounted with their own size: a text stored in a vector
+// is accounted in the vector's storage only once.
+struct MemoryUsage {
+    // Bytes of the objects and of the used part of their heap storage.
+    uint64_t used {};
+    // Bytes of the objects and of their whole heap storage (used or not).
+    uint64_t reserved {};
+    // Heap allocations currently held.
+    uint64_t allocations {};
+    // Tokens of the texts.
+    uint64_t tokens {};
+    // Nodes.
+    uint64_t nodes {};
+
+    MemoryUsage& operator+=(const MemoryUsage& other) {
+        used += other.used;
+        reserved += other.reserved;
+        allocations += other.allocations;
+        tokens += other.tokens;
+        nodes += other.nodes;
+        return *this;
+    }
+
+    // Accounts an object of the given size (stored in place).
+    void add_object(uint64_t size) {
+        used += size;
+        reserved += size;
+    }
+
+    // Accounts an object stored in the storage of another one (e.g. in a vector),
+    // given its own usage: its size is already accounted with the storage.
+    void add_stored(const MemoryUsage& usage, uint64_t size) {
+        *this += usage;
+        used -= size;
+        reserved -= size;
+    }
+
+    // Accounts the heap storage of a string (the string itself is not accounted).
+    void add_storage(const std::string& str) {
+        // Short strings are stored in the object itself
+        auto data = reinterpret_cast<uintptr_t>(str.data());
+        auto object = reinterpret_cast<uintptr_t>(&str);
+        if (data >= object && data < object + sizeof(str)) {
+            return;
+        }
+        used += str.size();
+        reserved += str.capacity() + 1;
+        allocations++;
+    }
+
+    // Accounts the heap storage of a vector (the vector itself is not accounted).
+    // Its elements are accounted as used but their own storage is not.
+    template <typename T>
+    void add_storage(const std::vector<T>& v) {
+        if (v.capacity() == 0) {
+            return;
+        }
+        used += v.size() * sizeof(T);
+        reserved += v.capacity() * sizeof(T);
+        allocations++;
+    }
+};
+} // namespace Tui
+
+#endif // MEMORY_H
@@ -1,6 +1,8 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include <cstdint>
+
 namespace Tui {
 struct Node {
     enum class Type {
@@ -8,14 +10,29 @@ struct Node {
         HLayout,
         VLayout,
         Divider,
+        VirtualBlock,
+        LogBlock,
+        FileBlock,
+        // Root of a frame whose boxes are listed by a Layout::Flatten function instead of being walked
+        // (e.g. a static layout, see static.h): it is not a Container. Left out if walked anyway
+        // (e.g. added to a Container), and presented as an empty frame if presented as a Node.
+        Flattened,
     };
 
-    explicit Node(Type type) :
-        type {type} {
-    }
+    explicit Node(Type type);
+    virtual ~Node() = default;
+
+    // Marks this node (and all its ancestors) as modified.
+    // Must be called after modifying the public fields of a node
+    // directly, so that a retained Presenter lays it out again.
+    void touch();
 
     Type type;
+    Node* parent {};
+
+    // Changes whenever this node or any of its descendants is modified.
+    uint64_t version {};
 };
 } // namespace Tui
 
-#endif // NODE_H
\ No newline at end of file
+#endif // NODE_H
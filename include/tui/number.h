@@ -0,0 +1,71 @@
+#ifndef NUMBER_H
+#define NUMBER_H
+
+#include <cstdint>
+#include <type_traits>
+
+namespace Tui {
+// Integer to be written straight into the storage of a Text or of a Block's line
+// (e.g. block << hex<4>(pc)), without temporaries. The characters are plain ones.
+struct Number {
+    // Maximum number of characters of a number (64 binary digits).
+    static constexpr uint32_t MaxDigits = 64;
+
+    // Magnitude and sign of the value.
+    uint64_t value {};
+    bool negative {};
+    uint8_t base {10};
+    // Minimum number of characters, filled with the fill character
+    // (before the sign if it is a space, after it otherwise).
+    uint8_t width {};
+    char fill {' '};
+    // Upper case hexadecimal digits.
+    bool upper {};
+
+    // Decimal number.
+    template <typename T>
+    static constexpr Number decimal(T value) {
+        static_assert(std::is_integral_v<T>, "numbers are integers");
+        if constexpr (std::is_signed_v<T>) {
+            if (value < 0) {
+                return {0 - static_cast<uint64_t>(value), true};
+            }
+        }
+        return {static_cast<uint64_t>(value)};
+    }
+
+    // Bits of the value (two's complement for negative values).
+    template <typename T>
+    static constexpr uint64_t bits(T value) {
+        static_assert(std::is_integral_v<T>, "numbers are integers");
+        return static_cast<std::make_unsigned_t<T>>(value);
+    }
+};
+
+// Hexadecimal number (upper case), padded with zeros to the given number of digits.
+template <uint32_t digits = 0, typename T>
+constexpr Number hex(T value) {
+    static_assert(digits <= 16, "at most 16 hexadecimal digits");
+    return {Number::bits(value), false, 16, digits, '0', true};
+}
+
+// Binary number, padded with zeros to the given number of digits.
+template <uint32_t digits = 0, typename T>
+constexpr Number bin(T value) {
+    static_assert(digits <= Number::MaxDigits, "at most 64 binary digits");
+    return {Number::bits(value), false, 2, digits, '0'};
+}
+
+// Decimal number, padded to the given width (right aligned).
+template <uint32_t width = 0, char fill = ' ', typename T>
+constexpr Number dec(T value) {
+    static_assert(width <= Number::MaxDigits, "at most 64 characters");
+    static_assert(fill == ' ' || fill == '0', "padded with spaces or zeros");
+    Number number = Number::decimal(value);
+    number.width = width;
+    number.fill = fill;
+    return number;
+}
+} // namespace Tui
+
+#endif // NUMBER_H
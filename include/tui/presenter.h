@@ -1,20 +1,213 @@
 #ifndef PRESENTER_H
 #define PRESENTER_H
 
+#include "cell.h"
+#include "layout.h"
 #include "node.h"
+#include "sink.h"
+#include "surface.h"
+#include "text.h"
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <ostream>
+#include <string>
+#include <vector>
 
 namespace Tui {
+class ThreadPool;
+
+namespace Detail {
+    // Content boxes presented in the rows of a laid out frame, so that the rows are presented
+    // without walking the tree: each row presents the spans starting at or before it and not ended yet.
+    struct RowPlan {
+        struct Span {
+            // Index of the content box.
+            uint32_t box;
+            // Rows [top, bottom) the box is presented in (within the ones of its ancestors).
+            uint32_t top;
+            uint32_t bottom;
+        };
+
+        // Rows planned.
+        uint32_t top {};
+        uint32_t bottom {};
+
+        // Spans of the content boxes visited by the rows, in pre-order.
+        std::vector<Span> spans;
+        // Spans starting at each row, in pre-order: starting[first[row - top]] to starting[first[row - top + 1]].
+        std::vector<uint32_t> first;
+        std::vector<uint32_t> starting;
+        // Number of spans ending at each row.
+        std::vector<uint32_t> ending;
+
+        // Containers of the box being planned.
+        std::vector<Span> ancestors;
+    };
+} // namespace Detail
+
 class Presenter {
 public:
-    explicit Presenter(std::ostream& os);
+    enum class Mode {
+        // The layout of the whole tree is computed from scratch at each present().
+        Immediate,
+        // The layout is kept between present() calls: only the nodes
+        // modified since the previous call (see Node::touch()) are laid out again.
+        // A Builder, whose frames are built anew, is laid out again as a whole.
+        Retained,
+    };
+
+    enum class Output {
+        // Each frame is fully written, line by line.
+        Full,
+        // Each frame is rendered into a grid of cells and compared with the
+        // previous one: only the changed cells are written, using cursor
+        // positioning escape sequences.
+        // The frame is drawn at the top left corner of the terminal.
+        Diff,
+    };
+
+    // Area of the frame to present (e.g. the size of the terminal),
+    // scrolled to the given position of the frame.
+    struct Viewport {
+        uint32_t width {};
+        uint32_t height {};
+        uint32_t x {};
+        uint32_t y {};
+    };
+
+    // Statistics of a presented frame.
+    struct Stats {
+        // Durations of the phases, in nanoseconds:
+        // listing the boxes of the tree (or checking the ones of the previous frame),
+        uint64_t build_ns {};
+        // measuring the modified nodes (bottom-up),
+        uint64_t measure_ns {};
+        // arranging them in their containers, finding the ending blocks (top-down) and planning the rows,
+        uint64_t arrange_ns {};
+        // presenting the rows in the buffer (and comparing the cells with Output::Diff),
+        uint64_t render_ns {};
+        // writing the buffer to the sink.
+        uint64_t write_ns {};
+
+        // Nodes of the tree, and the ones measured again.
+        uint32_t nodes {};
+        uint32_t measured_nodes {};
+        // Rows presented (the ones of the viewport, if any).
+        uint32_t rows {};
+
+        // Bytes written to the sink (0 if nothing changed with Output::Diff),
+        // and SGR escape sequences among them.
+        uint64_t bytes {};
+        uint64_t sgr_sequences {};
+
+        // Storages of the presenter that had to grow during the frame (0 once warmed up):
+        // its buffers, layout, row plan, bands and surfaces, each counted once however
+        // many times it was reallocated.
+        uint32_t growths {};
+    };
+
+    // Each frame is accumulated in a buffer and then written to
+    // the sink (or to the stream, flushing it) at once.
+    explicit Presenter(std::ostream& os, Mode mode = Mode::Immediate);
+    explicit Presenter(Sink& sink, Mode mode = Mode::Immediate);
+    ~Presenter();
+
+    void set_output(Output output);
+
+    // Wraps each frame in the synchronized update escape sequences,
+    // so that the terminal displays it at once.
+    void set_synchronized_update(bool enabled);
+
+    // Interprets the SGR escape sequences of the texts and writes only the changes
+    // of style between consecutive characters, with the shortest sequences.
+    // The lines are no longer reset at their end: the output is smaller
+    // but not the same bytes (the displayed content is the same).
+    // Frames are then presented on the calling thread only (see set_threads()).
+    void set_minimal_sgr(bool enabled);
+
+    // Presents only the given area of each frame (the whole frame by default).
+    // Nodes outside the viewport are not presented at all.
+    void set_viewport(std::optional<Viewport> viewport);
 
     void present(const Node& root_node);
 
+    // Presents a static layout (see static.h): its boxes are listed
+    // by code generated for its structure instead of walking the tree.
+    template <typename Root, typename = decltype(&Root::flatten)>
+    void present(const Root& root) {
+        present_tree(root, &Root::flatten);
+    }
+
+    // Lays out the tree and renders the frame into the surface, instead of writing it to the sink
+    // (on the calling thread, within the viewport if any). The layout is kept as by present().
+    void render(const Node& root_node, Surface& surface);
+
+    template <typename Root, typename = decltype(&Root::flatten)>
+    void render(const Root& root, Surface& surface) {
+        present_tree(root, &Root::flatten, &surface);
+    }
+
+    // Presents the rows of large frames in bands on the given number of threads
+    // (1, the default, presents them on the calling thread only).
+    // The bands are written to their own buffers, then appended in order:
+    // the output is the same as the serial one.
+    // Applies to Output::Full only. The providers of the virtual blocks
+    // are then called concurrently.
+    void set_threads(uint32_t threads);
+
+    // Collects the statistics of each presented frame (see stats()).
+    // Disabled by default: nothing is measured then.
+    // Available only if the library is built with TUI_STATS (stats() is always empty otherwise).
+    void set_stats(bool enabled);
+
+    // Statistics of the last presented frame.
+    const Stats& stats() const;
+
+    // Forces the next present() to repaint the whole frame
+    // (meaningful only with Output::Diff).
+    void invalidate();
+
 private:
-    std::ostream& os;
+    void present_tree(const Node& root, Layout::Flatten flatten, Surface* surface = nullptr);
+    bool present_layout();
+    void render_surface(Surface& surface);
+    bool present_diff();
+
+    std::unique_ptr<Sink> stream_sink;
+    Sink& sink;
+    Mode mode;
+    Output output {Output::Full};
+    bool synchronized_update {};
+    bool minimal_sgr {};
+    bool collect_stats {};
+    Stats last_stats;
+    std::optional<Viewport> viewport;
+
+    Layout layout;
+    Detail::RowPlan plan;
+
+    // Content of the frame being presented.
+    std::string buffer;
+
+    // Line produced by the provider of a virtual block.
+    Text scratch;
+    // Spans presented in the current row.
+    std::vector<uint32_t> active;
+
+    // Rows presented in parallel.
+    struct Band {
+        std::string buffer;
+        Text scratch;
+        std::vector<uint32_t> active;
+    };
+    std::unique_ptr<ThreadPool> pool;
+    std::vector<Band> bands;
+
+    // Frame being rendered and the previous one (Output::Diff).
+    Surface back;
+    Surface front;
 };
 } // namespace Tui
 
-#endif // PRESENTER_H
\ No newline at end of file
+#endif // PRESENTER_H
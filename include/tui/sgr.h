@@ -0,0 +1,86 @@
+#ifndef SGR_H
+#define SGR_H
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace Tui {
+// Select Graphic Rendition escape sequence built at compile time
+// (e.g. "\033[38;5;208m").
+struct Sgr {
+    char chars[20] {};
+    uint8_t length {};
+
+    constexpr std::string_view view() const {
+        return {chars, length};
+    }
+
+    constexpr void append(std::string_view str) {
+        for (char ch : str) {
+            chars[length++] = ch;
+        }
+    }
+
+    constexpr void append(uint8_t code) {
+        if (code >= 100)
+            chars[length++] = static_cast<char>('0' + code / 100);
+        if (code >= 10)
+            chars[length++] = static_cast<char>('0' + code / 10 % 10);
+        chars[length++] = static_cast<char>('0' + code % 10);
+    }
+};
+
+// Builds the sequence prefix + code + "m".
+constexpr Sgr make_sgr(std::string_view prefix, uint8_t code) {
+    Sgr sgr {};
+    sgr.append(prefix);
+    sgr.append(code);
+    sgr.append("m");
+    return sgr;
+}
+
+// Builds the sequence setting the 24-bit foreground (or background) color 0xRRGGBB.
+constexpr Sgr make_rgb_sgr(uint32_t rgb, bool background = false) {
+    Sgr sgr {};
+    sgr.append(background ? "\033[48;2;" : "\033[38;2;");
+    sgr.append(static_cast<uint8_t>(rgb >> 16));
+    sgr.append(";");
+    sgr.append(static_cast<uint8_t>(rgb >> 8));
+    sgr.append(";");
+    sgr.append(static_cast<uint8_t>(rgb));
+    sgr.append("m");
+    return sgr;
+}
+
+template <std::size_t... codes>
+constexpr std::array<Sgr, sizeof...(codes)> make_sgr_table(std::string_view prefix, std::index_sequence<codes...>) {
+    return {make_sgr(prefix, static_cast<uint8_t>(codes))...};
+}
+
+// Foreground colors of the 256 colors palette: PaletteSgr[code] is "\033[38;5;<code>m".
+inline constexpr std::array<Sgr, 256> PaletteSgr = make_sgr_table("\033[38;5;", std::make_index_sequence<256> {});
+
+// Attributes (and 8/16 colors): AttrSgr[code] is "\033[<code>m".
+inline constexpr std::array<Sgr, 256> AttrSgr = make_sgr_table("\033[", std::make_index_sequence<256> {});
+
+inline constexpr std::string_view ResetSgr = AttrSgr[0].view();
+
+// 24-bit colors: RgbSgr<0xRRGGBB> is "\033[38;2;<RR>;<GG>;<BB>m".
+template <uint32_t rgb>
+inline constexpr Sgr RgbSgr = make_rgb_sgr(rgb);
+template <uint32_t rgb>
+inline constexpr Sgr BgRgbSgr = make_rgb_sgr(rgb, true);
+
+// Appends the decimal representation of a parameter of an escape sequence.
+inline void append_parameter(std::string& out, uint32_t value) {
+    char chars[10];
+    auto [end, ec] = std::to_chars(chars, chars + sizeof(chars), value);
+    out.append(chars, end);
+}
+} // namespace Tui
+
+#endif // SGR_H
@@ -0,0 +1,57 @@
+#ifndef SINK_H
+#define SINK_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace Tui {
+// Destination of the frames of a Presenter.
+// A frame is written to the sink at once, with a single write() call.
+struct Sink {
+    virtual ~Sink() = default;
+
+    virtual void write(std::string_view frame) = 0;
+};
+
+// Appends the frames to a string.
+// The string is never cleared by the sink: its storage can be reused
+// by clearing it between frames.
+struct StringSink : Sink {
+    explicit StringSink(std::string& buffer) :
+        buffer {buffer} {
+    }
+
+    void write(std::string_view frame) override {
+        buffer.append(frame);
+    }
+
+    std::string& buffer;
+};
+
+// Writes the frames to a stream, flushing it after each frame.
+struct StreamSink : Sink {
+    explicit StreamSink(std::ostream& os) :
+        os {os} {
+    }
+
+    void write(std::string_view frame) override;
+
+    std::ostream& os;
+};
+
+// Writes the frames to a file descriptor (e.g. STDOUT_FILENO)
+// with a single write(2) syscall per frame (unless interrupted).
+// A non-blocking descriptor is waited for with poll(2) while it is full.
+struct FdSink : Sink {
+    explicit FdSink(int fd) :
+        fd {fd} {
+    }
+
+    void write(std::string_view frame) override;
+
+    int fd;
+};
+} // namespace Tui
+
+#endif // SINK_H
@@ -0,0 +1,169 @@
+#ifndef STATIC_H
+#define STATIC_H
+
+#include "block.h"
+#include "divider.h"
+#include "fileblock.h"
+#include "layout.h"
+#include "logblock.h"
+#include "memory.h"
+#include "node.h"
+#include "virtualblock.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Layouts whose structure is known at compile time, e.g.
+//
+//     Static::HLayout<Static::Block<20>, Static::Divider<'|'>, Static::VLayout<...>> layout;
+//     layout.get<0>() << "registers" << endl;
+//     presenter.present(layout);
+//
+// All the nodes live inline in a single object: no node is allocated,
+// and the boxes of the Layout are listed by code generated for the structure
+// instead of walking the tree. The frames are presented as the ones of dynamic trees.
+//
+// A static layout can be the root of a frame only, presented with its own flatten() (a Node of type
+// Node::Type::Flattened, not a Container: see Node::Type). It cannot be copied nor moved since
+// its children refer to it.
+namespace Tui::Static {
+inline constexpr uint32_t AutoWidth = UINT32_MAX;
+
+template <uint32_t fixed_width = AutoWidth>
+struct Block : Tui::Block {
+    Block() :
+        Tui::Block {fixed_width == AutoWidth ? std::nullopt : std::optional<uint32_t> {fixed_width}} {
+    }
+};
+
+template <char ch>
+struct Divider : Tui::Divider {
+    Divider() :
+        Tui::Divider {Text {std::string(1, ch)}} {
+    }
+};
+
+template <Node::Type node_type, typename... Children>
+struct Container;
+
+namespace Detail {
+    // Number of boxes of the subtree of a node.
+    template <typename T>
+    struct Size : std::integral_constant<uint32_t, 1> {};
+
+    template <Node::Type type, typename... Children>
+    struct Size<Container<type, Children...>> : std::integral_constant<uint32_t, (1 + ... + Size<Children>::value)> {};
+
+    template <typename T>
+    constexpr Layout::Type::BoxType box_type(Node::Type parent) {
+        if constexpr (std::is_base_of_v<Tui::Block, T>) {
+            return Layout::Type::Block;
+        } else if constexpr (std::is_base_of_v<Tui::VirtualBlock, T>) {
+            return Layout::Type::VirtualBlock;
+        } else if constexpr (std::is_base_of_v<Tui::LogBlock, T>) {
+            return Layout::Type::LogBlock;
+        } else if constexpr (std::is_base_of_v<Tui::FileBlock, T>) {
+            return Layout::Type::FileBlock;
+        } else {
+            static_assert(std::is_base_of_v<Tui::Divider, T>, "not a node of a static layout");
+            // Dividers span the direction of their layout
+            return parent == Node::Type::HLayout ? Layout::Type::HDivider : Layout::Type::VDivider;
+        }
+    }
+
+    inline void set_box(Layout::Box& box, const Node& node, Layout::Type::BoxType type, uint32_t end) {
+        box = {};
+        box.node = &node;
+        box.type = type;
+        box.end = end;
+        box.version = node.version;
+    }
+
+    template <typename T>
+    void write_boxes(const T& node, Layout::Box* boxes, uint32_t index, Node::Type parent) {
+        set_box(boxes[index], node, box_type<T>(parent), index + 1);
+    }
+
+    template <Node::Type type, typename... Children>
+    void write_boxes(const Container<type, Children...>& node, Layout::Box* boxes, uint32_t index, Node::Type) {
+        node.write_boxes(boxes, index);
+    }
+} // namespace Detail
+
+// Horizontal or vertical layout of the given children, laid out in this order.
+template <Node::Type node_type, typename... Children>
+struct Container : Node {
+    static_assert(node_type == Node::Type::HLayout || node_type == Node::Type::VLayout);
+
+    Container() :
+        Node {Node::Type::Flattened} {
+        std::apply(
+            [this](auto&... child) {
+                ((child.parent = this), ...);
+            },
+            children);
+    }
+
+    Container(const Container&) = delete;
+    Container& operator=(const Container&) = delete;
+
+    template <size_t i>
+    auto& get() {
+        return std::get<i>(children);
+    }
+
+    template <size_t i>
+    const auto& get() const {
+        return std::get<i>(children);
+    }
+
+    // Memory held by the layout (see MemoryUsage): its children are stored in place.
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage;
+        usage.add_object(sizeof(Container));
+        usage.nodes = 1;
+        std::apply(
+            [&usage](const auto&... child) {
+                (usage.add_stored(child.memory_usage(), sizeof(child)), ...);
+            },
+            children);
+        return usage;
+    }
+
+    // Lists the boxes of the layout rooted at the given node (see Layout::update()).
+    static void flatten(const Node& root, std::vector<Layout::Box>& boxes) {
+        boxes.resize(Detail::Size<Container>::value);
+        static_cast<const Container&>(root).write_boxes(boxes.data(), 0);
+    }
+
+    // Writes the boxes of this subtree, in pre-order, starting at the given index.
+    void write_boxes(Layout::Box* boxes, uint32_t index) const {
+        Detail::set_box(boxes[index], *this,
+                        node_type == Node::Type::HLayout ? Layout::Type::HLayout : Layout::Type::VLayout,
+                        index + Detail::Size<Container>::value);
+        write_children(boxes, index + 1, std::index_sequence_for<Children...> {});
+    }
+
+    std::tuple<Children...> children;
+
+private:
+    template <size_t... i>
+    void write_children(Layout::Box* boxes, uint32_t index, std::index_sequence<i...>) const {
+        // Each child starts after the boxes of the previous ones
+        ((Detail::write_boxes(std::get<i>(children), boxes, index, node_type), index += Detail::Size<Children>::value),
+         ...);
+    }
+};
+
+template <typename... Children>
+using HLayout = Container<Node::Type::HLayout, Children...>;
+
+template <typename... Children>
+using VLayout = Container<Node::Type::VLayout, Children...>;
+} // namespace Tui::Static
+
+#endif // STATIC_H
@@ -0,0 +1,62 @@
+#ifndef STYLE_H
+#define STYLE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Tui {
+struct Style {
+    // Colors are packed in 32 bits:
+    // * Default:            the terminal's default color
+    // * Palette | index:    an entry of the 256 colors palette
+    // * Rgb | 0xRRGGBB:     a 24-bit color
+    struct Color {
+        using ColorType = uint32_t;
+        static constexpr ColorType Default = 0;
+        static constexpr ColorType Palette = 1 << 24;
+        static constexpr ColorType Rgb = 2 << 24;
+        static constexpr ColorType Mask = 0xFF << 24;
+    };
+
+    struct Attr {
+        using AttrType = uint16_t;
+        static constexpr AttrType Bold = 1 << 0;
+        static constexpr AttrType Dim = 1 << 1;
+        static constexpr AttrType Italic = 1 << 2;
+        static constexpr AttrType Underline = 1 << 3;
+        static constexpr AttrType Blink = 1 << 4;
+        static constexpr AttrType RapidBlink = 1 << 5;
+        static constexpr AttrType Reverse = 1 << 6;
+        static constexpr AttrType Hidden = 1 << 7;
+        static constexpr AttrType Strike = 1 << 8;
+    };
+
+    bool operator==(const Style& other) const {
+        return fg == other.fg && bg == other.bg && attrs == other.attrs;
+    }
+    bool operator!=(const Style& other) const {
+        return !(*this == other);
+    }
+
+    // Updates the style with the parameters of a SGR escape sequence (e.g. "\033[1;38;5;9m").
+    // Returns false (leaving the style untouched) if the sequence is not a SGR sequence,
+    // or if one of its parameters is not represented by the style (e.g. 58, an underline color):
+    // the sequence is then to be written as is.
+    bool apply(std::string_view sequence);
+
+    // Appends the SGR escape sequence that sets this style
+    // on a terminal, whatever its current style is.
+    void sgr(std::string& out) const;
+
+    // Appends the shortest SGR escape sequence that changes the style
+    // of a terminal from the given one to this one (nothing if they are equal).
+    void sgr(std::string& out, const Style& from) const;
+
+    Color::ColorType fg {Color::Default};
+    Color::ColorType bg {Color::Default};
+    Attr::AttrType attrs {};
+};
+} // namespace Tui
+
+#endif // STYLE_H
@@ -0,0 +1,45 @@
+#ifndef SURFACE_H
+#define SURFACE_H
+
+#include "cell.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Tui {
+// Frame rendered as a grid of cells (see Presenter::render()), row after row:
+// the glyph and the style of each column, as a terminal would display them.
+// Frames can be inspected and compared without parsing escape sequences.
+//
+// A cell keeps at most 4 bytes of UTF-8 (see Cell::Glyph): the bytes of longer glyphs are cut,
+// and a zero width character (e.g. a combining mark) is appended to the glyph before it only if
+// its bytes fit. Escape sequences other than SGR (e.g. OSC) are not kept, nor the SGR sequences
+// with parameters a Style does not represent (e.g. an underline color, see Style::apply()).
+struct Surface {
+    const Cell& at(uint32_t x, uint32_t y) const {
+        return cells[y * width + x];
+    }
+
+    bool operator==(const Surface& other) const {
+        return width == other.width && height == other.height && cells == other.cells;
+    }
+    bool operator!=(const Surface& other) const {
+        return !(*this == other);
+    }
+
+    // Glyphs of the rows, each row followed by \n.
+    std::string text() const;
+    void append_text(std::string& out) const;
+
+    // Glyphs of the rows, each row followed by \n, along with the shortest SGR
+    // escape sequences that change the style between them (reset at the end).
+    std::string ansi() const;
+    void append_ansi(std::string& out) const;
+
+    std::vector<Cell> cells;
+    uint32_t width {};
+    uint32_t height {};
+};
+} // namespace Tui
+
+#endif // SURFACE_H
@@ -1,13 +1,26 @@
 #ifndef TEXT_H
 #define TEXT_H
 
+#include "memory.h"
+#include "number.h"
 #include "token.h"
 #include "traits.h"
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Tui {
+template <typename... Args>
+class Formatted;
+
+namespace Detail {
+    template <typename T>
+    struct IsFormatted : std::false_type {};
+    template <typename... Args>
+    struct IsFormatted<Formatted<Args...>> : std::true_type {};
+} // namespace Detail
+
 class Text {
 public:
     using Length = Explicit<uint32_t, struct LengthTag>;
@@ -19,22 +32,26 @@ public:
     Text(const Token& token);
     Text(Token&& token);
 
-    template <typename T, typename = std::enable_if_t<std::negation_v<std::disjunction<
-                              std::is_same<std::decay_t<T>, Text>, std::is_same<std::decay_t<T>, Token>>>>>
-    Text(T&& value) {
-        std::string s;
+    Text(const Number& number);
 
-        if constexpr (std::is_arithmetic_v<std::decay_t<T>>) {
-            s = std::to_string(value);
-        } else {
-            s = std::forward<T>(value);
-        }
+    // Formatted text (see format.h).
+    template <typename... Args>
+    Text(const Formatted<Args...>& formatted) {
+        formatted.append_to(*this);
+    }
 
-        tokens.reserve(s.size());
-        for (const auto& c : s) {
-            tokens.emplace_back(c);
+    template <typename T,
+              typename = std::enable_if_t<std::negation_v<std::disjunction<
+                  std::is_base_of<Text, std::decay_t<T>>, std::is_same<std::decay_t<T>, Token>,
+                  std::is_same<std::decay_t<T>, Number>, Detail::IsFormatted<std::decay_t<T>>>>>>
+    Text(T&& value) {
+        if constexpr (std::is_integral_v<std::decay_t<T>> && !std::is_same_v<std::decay_t<T>, bool>) {
+            *this += Number::decimal(value);
+        } else if constexpr (std::is_arithmetic_v<std::decay_t<T>>) {
+            append_plain(std::to_string(value));
+        } else {
+            append(std::string_view {value});
         }
-        length = s.size();
     }
 
     Text& operator=(const Token& token);
@@ -43,10 +60,37 @@ public:
     Text& operator+=(const Token& token);
     Text& operator+=(Token&& token);
     Text& operator+=(const Text& text);
+    // Writes the characters of the number straight into the storage of the text.
+    Text& operator+=(const Number& number);
+
+    template <typename... Args>
+    Text& operator+=(const Formatted<Args...>& formatted) {
+        formatted.append_to(*this);
+        return *this;
+    }
+
+    // Removes all the tokens, keeping the allocated storage.
+    void clear();
+
+    // Memory held by the text (see MemoryUsage).
+    MemoryUsage memory_usage() const;
 
     friend Text operator+(const Text& text1, const Text& text2);
+    friend struct Decoration;
+    friend struct Block;
+    friend struct FileBlock;
+    friend struct LogBlock;
+    friend class LogQueue;
+    template <typename... Args>
+    friend class Formatted;
 
     std::string str() const;
+    std::string_view view() const;
+    // Bytes of substr(RawIndex {0}, len), without copying them.
+    std::string_view view(Length len) const;
+    // The same, along with their number of columns: less than len if a wide character
+    // does not fit in the last column.
+    std::string_view view(Length len, Length& columns) const;
     Length size() const;
     Text substr(RawIndex start) const;
     Text substr(RawIndex start, RawLength len) const;
@@ -55,9 +99,77 @@ public:
     Text lpad(Length len, char ch = ' ') const;
     std::optional<RawIndex> find(char ch, RawIndex pos = RawIndex {0}, RawLength len = RawLength {UINT32_MAX}) const;
 
+    // Calls f(std::string_view token, uint32_t size) for each token.
+    template <typename F>
+    void for_each(F&& f) const {
+        uint32_t i = 0;
+        uint32_t offset = 0;
+        for (const Run& run : runs) {
+            for (; i < run.index; i++, offset++) {
+                f(std::string_view {bytes.data() + offset, 1}, 1u);
+            }
+            f(std::string_view {bytes.data() + run.offset, run.bytes}, run.size);
+            i++;
+            offset = run.offset + run.bytes;
+        }
+        for (; i < count; i++, offset++) {
+            f(std::string_view {bytes.data() + offset, 1}, 1u);
+        }
+    }
+
+    // Calls f(std::string_view bytes, uint32_t size) for each token that is not a plain
+    // character and for each sequence of plain characters (of size columns) between them.
+    template <typename F>
+    void for_each_chunk(F&& f) const {
+        uint32_t i = 0;
+        uint32_t offset = 0;
+        for (const Run& run : runs) {
+            if (i < run.index) {
+                f(std::string_view {bytes.data() + offset, run.index - i}, run.index - i);
+            }
+            f(std::string_view {bytes.data() + run.offset, run.bytes}, run.size);
+            i = run.index + 1;
+            offset = run.offset + run.bytes;
+        }
+        if (i < count) {
+            f(std::string_view {bytes.data() + offset, count - i}, count - i);
+        }
+    }
+
 protected:
-    std::vector<Token> tokens;
+    // A token that is not a plain 1-byte, 1-column character
+    // (e.g. a zero-width escape sequence emitted by a Decorator).
+    struct Run {
+        uint32_t index {}; // raw index of the token
+        uint32_t offset {}; // offset of the token in bytes
+        uint32_t bytes {};
+        uint32_t size {};
+    };
+
+    // Appends characters: escape sequences (e.g. SGR) are zero width tokens,
+    // UTF-8 code points are grouped in single tokens (of 0, 1 or 2 columns),
+    // any other byte is a plain character.
+    void append(std::string_view str);
+
+    // Appends plain characters (1 byte and 1 column each).
+    void append_plain(std::string_view str);
+
+    // Appends a single token of the given display size.
+    void append(std::string_view str, uint32_t size);
+
+    // Appends the raw tokens [start, end) of the given text.
+    void append(const Text& text, uint32_t start, uint32_t end);
+
+    // Raw index of the end of the tokens starting at the given index
+    // that fill the given display length (the columns filled are stored in columns, if given).
+    uint32_t end_of(uint32_t start, uint32_t len, uint32_t* columns = nullptr) const;
+    uint32_t offset_of(uint32_t index) const;
+    std::vector<Run>::const_iterator run_at(uint32_t index) const;
+
+    std::string bytes;
+    std::vector<Run> runs;
+    uint32_t count {};
     Length length {};
 };
 } // namespace Tui
-#endif // TEXT_H
\ No newline at end of file
+#endif // TEXT_H
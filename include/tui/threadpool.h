@@ -0,0 +1,50 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Tui {
+// Fixed set of worker threads running the jobs of one batch at a time.
+class ThreadPool {
+public:
+    // The calling thread takes part in each batch:
+    // threads - 1 workers are started.
+    explicit ThreadPool(uint32_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Calls job(i) for each i in [0, count), in any order and on any thread,
+    // and returns once all of them have returned.
+    void run(uint32_t count, const std::function<void(uint32_t)>& job);
+
+    uint32_t size() const;
+
+private:
+    void work();
+    void run_jobs();
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    // Current batch.
+    const std::function<void(uint32_t)>* job {};
+    uint32_t count {};
+    std::atomic<uint32_t> next {};
+    uint32_t finished {};
+    uint64_t batch {};
+    bool stop {};
+};
+} // namespace Tui
+
+#endif // THREADPOOL_H
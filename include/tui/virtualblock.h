@@ -0,0 +1,45 @@
+#ifndef VIRTUALBLOCK_H
+#define VIRTUALBLOCK_H
+
+#include "memory.h"
+#include "node.h"
+#include "text.h"
+#include <functional>
+#include <optional>
+
+namespace Tui {
+// Block whose lines are not stored but produced on demand:
+// the provider is called only for the lines actually presented.
+struct VirtualBlock : Node {
+    // Fills the given (empty) text with the line at the given index.
+    using Provider = std::function<void(uint32_t index, Text& line)>;
+
+    explicit VirtualBlock(uint32_t count, Provider provider, std::optional<uint32_t> width = std::nullopt) :
+        Node {Node::Type::VirtualBlock},
+        count {count},
+        provider {std::move(provider)},
+        width {width} {
+    }
+
+    // Memory held by the virtual block (see MemoryUsage):
+    // the state captured by the provider is not accounted.
+    MemoryUsage memory_usage() const {
+        MemoryUsage usage;
+        usage.add_object(sizeof(VirtualBlock));
+        usage.nodes = 1;
+        return usage;
+    }
+
+    // Number of lines.
+    uint32_t count;
+    Provider provider;
+    // Fixed width. Otherwise the block has no width of its own: it fills the width of a vertical layout,
+    // or the width left as the last child of a horizontal layout (none as another child).
+    std::optional<uint32_t> width;
+    // Fixed number of rows (the lines from offset to the end otherwise).
+    std::optional<uint32_t> height;
+    // Index of the line presented at the first row.
+    uint32_t offset {};
+};
+} // namespace Tui
+#endif // VIRTUALBLOCK_H
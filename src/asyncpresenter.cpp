@@ -0,0 +1,104 @@
+#include "tui/asyncpresenter.h"
+#include "tui/presenter.h"
+
+namespace Tui {
+AsyncPresenter::AsyncPresenter(Presenter& presenter) :
+    presenter {presenter},
+    thread {[this] {
+        render();
+    }} {
+}
+
+AsyncPresenter::~AsyncPresenter() {
+    {
+        std::lock_guard lock {mutex};
+        stop = true;
+    }
+    wake.notify_all();
+    thread.join();
+}
+
+void AsyncPresenter::submit(std::shared_ptr<const Node> root) {
+    submitted++;
+
+    // The superseded frame (if any) is released here, by the producer
+    std::unique_ptr<Frame> superseded {mailbox.exchange(new Frame {std::move(root)})};
+    if (superseded) {
+        dropped_frames++;
+    }
+
+    // The mutex is needed only if the render thread is about to sleep (or sleeping):
+    // it then either sees the frame or gets notified
+    if (sleeping) {
+        std::lock_guard lock {mutex};
+        wake.notify_one();
+    }
+}
+
+void AsyncPresenter::set_max_fps(uint32_t fps) {
+    using namespace std::chrono;
+    min_interval = fps > 0 ? duration_cast<steady_clock::duration>(seconds {1}).count() / fps : 0;
+}
+
+void AsyncPresenter::wait() {
+    std::unique_lock lock {mutex};
+    idle.wait(lock, [this] {
+        return presented_frames + dropped_frames == submitted;
+    });
+}
+
+uint64_t AsyncPresenter::presented() const {
+    return presented_frames;
+}
+
+uint64_t AsyncPresenter::dropped() const {
+    return dropped_frames;
+}
+
+std::unique_ptr<AsyncPresenter::Frame> AsyncPresenter::take() {
+    std::unique_lock lock {mutex};
+
+    sleeping = true;
+    wake.wait(lock, [this] {
+        return stop || mailbox.load() != nullptr;
+    });
+    sleeping = false;
+
+    return std::unique_ptr<Frame> {mailbox.exchange(nullptr)};
+}
+
+void AsyncPresenter::render() {
+    // The last presented tree is kept alive until the next one is presented:
+    // a retained layout can then recognize it, and the nodes of a new tree
+    // cannot be allocated at the addresses of its nodes.
+    std::shared_ptr<const Node> current;
+    std::chrono::steady_clock::time_point last {};
+
+    while (true) {
+        {
+            // Let the frames submitted meanwhile coalesce
+            std::chrono::steady_clock::duration interval {min_interval};
+            std::unique_lock lock {mutex};
+            wake.wait_until(lock, last + interval, [this] {
+                return stop;
+            });
+        }
+
+        std::unique_ptr<Frame> frame = take();
+        if (!frame) {
+            // Stopped, with no pending frame
+            return;
+        }
+
+        current = std::move(frame->root);
+        last = std::chrono::steady_clock::now();
+        presenter.present(*current);
+
+        {
+            std::lock_guard lock {mutex};
+            presented_frames++;
+        }
+        idle.notify_all();
+    }
+}
+} // namespace Tui
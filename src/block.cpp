@@ -1,4 +1,6 @@
 #include "tui/block.h"
+#include <cstring>
+#include <utility>
 
 namespace Tui {
 Block::Block(std::optional<uint32_t> width) :
@@ -9,37 +11,138 @@ Block::Block(std::optional<uint32_t> width) :
 Block& Tui::Block::operator<<(const Text& text) {
     // No lines yet: add one
     if (lines.empty())
-        lines.emplace_back();
+        new_line();
 
     // Split text in lines by \n
-    Text::RawIndex i {0};
+    uint32_t i = 0;
 
-    std::optional<Text::RawIndex> new_line;
+    std::optional<Text::RawIndex> new_line_index;
     do {
-        new_line = text.find('\n', i);
-        if (new_line) {
-            lines.back() += text.substr(i, Text::RawLength {*new_line - i});
-            lines.emplace_back();
-            i = Text::Index {*new_line + 1};
+        new_line_index = text.find('\n', Text::RawIndex {i});
+        if (new_line_index) {
+            lines.back().append(text, i, *new_line_index);
+            new_line();
+            i = *new_line_index + 1;
         }
-    } while (new_line);
+    } while (new_line_index);
+
+    lines.back().append(text, i, text.count);
 
-    lines.back() += text.substr(i);
+    touch();
 
     return *this;
 }
 
+Block& Tui::Block::operator<<(Text&& text) {
+    // No lines yet: add one
+    if (lines.empty())
+        new_line();
+
+    // A single line appended to an empty line is swapped with it:
+    // the text gets the storage of the line (kept for the caller to reuse)
+    if (lines.back().count == 0 && !text.find('\n')) {
+        std::swap(lines.back(), text);
+        text.clear();
+        touch();
+        return *this;
+    }
+    return *this << static_cast<const Text&>(text);
+}
+
+Block& Tui::Block::operator<<(std::string_view str) {
+    // No lines yet: add one
+    if (lines.empty())
+        new_line();
+
+    // Split str in lines by \n
+    while (const auto* end = static_cast<const char*>(std::memchr(str.data(), '\n', str.size()))) {
+        auto n = static_cast<size_t>(end - str.data());
+        lines.back().append(str.substr(0, n));
+        new_line();
+        str.remove_prefix(n + 1);
+    }
+
+    lines.back().append(str);
+
+    touch();
+
+    return *this;
+}
+
+Block& Tui::Block::operator<<(const std::string& str) {
+    return *this << std::string_view {str};
+}
+
+Block& Tui::Block::operator<<(const char* str) {
+    return *this << std::string_view {str};
+}
+
 Block& Tui::Block::operator<<(Block& (*manip)(Block&)) {
     return manip(*this);
 }
 
-Block& endl(Block& b) {
-    b.lines.emplace_back();
-    return b;
+Block& Tui::Block::operator<<(const Number& number) {
+    // No lines yet: add one
+    if (lines.empty())
+        new_line();
+
+    lines.back() += number;
+
+    touch();
+
+    return *this;
+}
+
+void Block::reserve(size_t count) {
+    lines.reserve(count);
+    spare.reserve(count);
+}
+
+void Block::clear() {
+    // Keep the lines (and their storage) for later
+    for (auto it = lines.rbegin(); it != lines.rend(); it++) {
+        spare.push_back(std::move(*it));
+    }
+    lines.clear();
+    touch();
 }
 
-Block& operator<<(const std::unique_ptr<Block>& block, const Text& text) {
-    return *block << text;
+MemoryUsage Block::memory_usage() const {
+    MemoryUsage usage;
+    usage.add_object(sizeof(Block));
+    usage.nodes = 1;
+
+    usage.add_storage(lines);
+    for (const auto& line : lines) {
+        usage.add_stored(line.memory_usage(), sizeof(Text));
+    }
+
+    // The spare lines are only kept for later: their storage is reserved, not used
+    MemoryUsage spare_usage;
+    spare_usage.add_storage(spare);
+    for (const auto& line : spare) {
+        spare_usage.add_stored(line.memory_usage(), sizeof(Text));
+    }
+    usage.reserved += spare_usage.reserved;
+    usage.allocations += spare_usage.allocations;
+
+    return usage;
+}
+
+void Block::new_line() {
+    if (spare.empty()) {
+        lines.emplace_back();
+        return;
+    }
+    lines.push_back(std::move(spare.back()));
+    spare.pop_back();
+    lines.back().clear();
+}
+
+Block& endl(Block& b) {
+    b.new_line();
+    b.touch();
+    return b;
 }
 
 Block& operator<<(const std::unique_ptr<Block>& block, Block& (*manip)(const std::unique_ptr<Block>&)) {
@@ -50,4 +153,4 @@ Block& endl(const std::unique_ptr<Block>& b) {
     return endl(*b);
 }
 
-} // namespace Tui
\ No newline at end of file
+} // namespace Tui
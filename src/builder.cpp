@@ -0,0 +1,141 @@
+#include "tui/builder.h"
+#include <algorithm>
+
+namespace Tui {
+Builder::Builder() :
+    Node(Node::Type::Flattened) {
+    reset();
+}
+
+void Builder::reset() {
+    nodes.clear();
+    types.clear();
+    ends.clear();
+    open.clear();
+    used_layouts = 0;
+    used_blocks = 0;
+    used_dividers = 0;
+
+    begin_layout(Layout::Type::VLayout);
+    touch();
+}
+
+void Builder::begin_horizontal_layout() {
+    begin_layout(Layout::Type::HLayout);
+}
+
+void Builder::begin_vertical_layout() {
+    begin_layout(Layout::Type::VLayout);
+}
+
+void Builder::end_layout() {
+    // The top-level layout is ended by flatten()
+    if (open.size() > 1) {
+        ends[open.back()] = static_cast<uint32_t>(nodes.size());
+        open.pop_back();
+    }
+}
+
+Block& Builder::block(std::optional<uint32_t> width) {
+    if (used_blocks == blocks.size()) {
+        blocks.emplace_back(width);
+    } else {
+        Block& block = blocks[used_blocks];
+        block.clear();
+        block.width = width;
+        block.height = std::nullopt;
+        block.offset = 0;
+    }
+    Block& block = blocks[used_blocks++];
+    push(block, Layout::Type::Block);
+    return block;
+}
+
+Divider& Builder::divider(const Text& text) {
+    if (used_dividers == dividers.size()) {
+        dividers.emplace_back(Text {text});
+    } else {
+        Text& divider_text = dividers[used_dividers].text;
+        divider_text.clear();
+        divider_text += text;
+    }
+    Divider& divider = dividers[used_dividers++];
+    add(divider);
+    return divider;
+}
+
+void Builder::add(const Node& node) {
+    if (node.type == Node::Type::Divider) {
+        // Dividers span the direction of their layout
+        push(node, types[open.back()] == Layout::Type::HLayout ? Layout::Type::HDivider : Layout::Type::VDivider);
+    } else {
+        push(node, Layout::box_type(node, nullptr));
+    }
+}
+
+uint32_t Builder::size() const {
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void Builder::flatten(const Node& root, std::vector<Layout::Box>& boxes) {
+    const auto& builder = static_cast<const Builder&>(root);
+    auto n = static_cast<uint32_t>(builder.nodes.size());
+
+    // The top box is the pooled top-level layout, not the builder: the boxes are listed again
+    // at each frame, even by a retained presenter (see Layout::build()), since the structure
+    // of the frame may change.
+    boxes.resize(n);
+    for (uint32_t i = 0; i < n; i++) {
+        Layout::Box& box = boxes[i];
+        box = {};
+        box.node = builder.nodes[i];
+        box.type = builder.types[i];
+        // The layouts not ended end with the frame
+        box.end = std::min(builder.ends[i], n);
+        box.version = box.node->version;
+    }
+}
+
+MemoryUsage Builder::memory_usage() const {
+    MemoryUsage usage;
+    usage.add_object(sizeof(Builder));
+    usage.add_storage(nodes);
+    usage.add_storage(types);
+    usage.add_storage(ends);
+    usage.add_storage(open);
+
+    // The pooled nodes are stored in the chunks of the deques
+    MemoryUsage spare_usage;
+    for (uint32_t i = 0; i < layouts.size(); i++) {
+        (i < used_layouts ? usage : spare_usage).add_object(sizeof(Node));
+    }
+    usage.nodes += used_layouts;
+    for (uint32_t i = 0; i < blocks.size(); i++) {
+        (i < used_blocks ? usage : spare_usage) += blocks[i].memory_usage();
+    }
+    for (uint32_t i = 0; i < dividers.size(); i++) {
+        (i < used_dividers ? usage : spare_usage) += dividers[i].memory_usage();
+    }
+
+    // The pooled nodes not used by the frame are only kept for later: their storage is reserved, not used
+    usage.reserved += spare_usage.reserved;
+    usage.allocations += spare_usage.allocations;
+    return usage;
+}
+
+void Builder::push(const Node& node, Layout::Type::BoxType type) {
+    nodes.push_back(&node);
+    types.push_back(type);
+    ends.push_back(static_cast<uint32_t>(nodes.size()));
+}
+
+void Builder::begin_layout(Layout::Type::BoxType type) {
+    // The layouts are plain nodes, not Containers: their box type gives their direction
+    if (used_layouts == layouts.size()) {
+        layouts.emplace_back(Node::Type::Flattened);
+    }
+    open.push_back(static_cast<uint32_t>(nodes.size()));
+    push(layouts[used_layouts++], type);
+    ends.back() = UINT32_MAX;
+}
+} // namespace Tui
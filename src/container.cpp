@@ -1,4 +1,9 @@
 #include "tui/container.h"
+#include "tui/block.h"
+#include "tui/divider.h"
+#include "tui/fileblock.h"
+#include "tui/logblock.h"
+#include "tui/virtualblock.h"
 
 namespace Tui {
 Tui::Container::Container(Node::Type type) :
@@ -6,6 +11,45 @@ Tui::Container::Container(Node::Type type) :
 }
 
 void Tui::Container::add_node(std::unique_ptr<Node>&& node) {
+    node->parent = this;
     children.emplace_back(std::move(node));
+    touch();
+}
+
+MemoryUsage Container::memory_usage() const {
+    MemoryUsage usage;
+
+    // The tree is walked with an explicit stack: its depth is not limited by the call stack
+    std::vector<const Node*> stack {this};
+    while (!stack.empty()) {
+        const Node& node = *stack.back();
+        stack.pop_back();
+
+        if (node.type == Node::Type::Block) {
+            usage += static_cast<const Block&>(node).memory_usage();
+        } else if (node.type == Node::Type::Divider) {
+            usage += static_cast<const Divider&>(node).memory_usage();
+        } else if (node.type == Node::Type::VirtualBlock) {
+            usage += static_cast<const VirtualBlock&>(node).memory_usage();
+        } else if (node.type == Node::Type::LogBlock) {
+            usage += static_cast<const LogBlock&>(node).memory_usage();
+        } else if (node.type == Node::Type::FileBlock) {
+            usage += static_cast<const FileBlock&>(node).memory_usage();
+        } else if (node.type == Node::Type::Flattened) {
+            // Its type, and so its size, is not known here
+            usage.nodes++;
+        } else {
+            const auto& container = static_cast<const Container&>(node);
+            usage.add_object(sizeof(Container));
+            usage.nodes++;
+            usage.add_storage(container.children);
+            usage.allocations += container.children.size();
+            for (const auto& child : container.children) {
+                stack.push_back(child.get());
+            }
+        }
+    }
+
+    return usage;
 }
 } // namespace Tui
\ No newline at end of file
@@ -1,94 +1,114 @@
 #include "tui/decorators.h"
 
-#define COLOR(c) Decorator("\033[38;5;" #c "m")
-#define ATTR(c) Decorator("\033[" #c "m")
-#define RESET() ATTR(0)
-#define COLORIZE(c, t) COLOR(c) + t + RESET()
-#define ATTRIBUTIZE(c, t) ATTR(c) + t + RESET()
-
 namespace Tui {
+Text Decoration::operator()(const Text& text) const {
+    Text decorated;
+    decorated.bytes.reserve(sequence.size() + text.bytes.size() + ResetSgr.size());
+    decorated.runs.reserve(text.runs.size() + 2);
+    decorated.append(sequence, 0);
+    decorated.append(text, 0, text.count);
+    decorated.append(ResetSgr, 0);
+    return decorated;
+}
+
+void Decoration::append(Text& text, std::string_view str) const {
+    text.append(sequence, 0);
+    text.append(str);
+    text.append(ResetSgr, 0);
+}
+
 Text color(Text&& text, uint8_t code) {
-    return Decorator {"\033[38;5;" + std::to_string(code) + "m"} + text + Decorator {"\033[0m"};
+    return Decoration {PaletteSgr[code].view()}(text);
 }
 
 Text attr(Text&& text, uint8_t code) {
-    return Decorator {"\033[" + std::to_string(code) + "m"} + text + Decorator {"\033[0m"};
+    return Decoration {AttrSgr[code].view()}(text);
+}
+
+Text rgb(Text&& text, uint32_t color) {
+    Sgr sgr = make_rgb_sgr(color);
+    return Decoration {sgr.view()}(text);
+}
+
+Text bg_rgb(Text&& text, uint32_t color) {
+    Sgr sgr = make_rgb_sgr(color, true);
+    return Decoration {sgr.view()}(text);
 }
 
 Text bold(Text&& text) {
-    return ATTRIBUTIZE(1, text);
+    return Bold(text);
 }
 
 Text reset() {
-    return Text {} + RESET();
+    return Decorator {ResetSgr};
 }
 
 Text red(Text&& text) {
-    return ATTRIBUTIZE(31, text);
+    return Red(text);
 }
 
 Text lightred(Text&& text) {
-    return COLORIZE(9, text);
+    return LightRed(text);
 }
 
 Text green(Text&& text) {
-    return ATTRIBUTIZE(32, text);
+    return Green(text);
 }
 
 Text lightgreen(Text&& text) {
-    return COLORIZE(10, text);
+    return LightGreen(text);
 }
 
 Text yellow(Text&& text) {
-    return ATTRIBUTIZE(33, text);
+    return Yellow(text);
 }
 
 Text lightyellow(Text&& text) {
-    return COLORIZE(11, text);
+    return LightYellow(text);
 }
 
 Text blue(Text&& text) {
-    return ATTRIBUTIZE(34, text);
+    return Blue(text);
 }
 
 Text lightblue(Text&& text) {
-    return COLORIZE(12, text);
+    return LightBlue(text);
 }
 
 Text magenta(Text&& text) {
-    return ATTRIBUTIZE(35, text);
+    return Magenta(text);
 }
 
 Text lightmagenta(Text&& text) {
-    return COLORIZE(13, text);
+    return LightMagenta(text);
 }
 
 Text cyan(Text&& text) {
-    return ATTRIBUTIZE(36, text);
+    return Cyan(text);
 }
 
 Text lightcyan(Text&& text) {
-    return COLORIZE(14, text);
+    return LightCyan(text);
 }
 
 Text gray(Text&& text) {
-    return COLORIZE(244, text);
+    return Gray(text);
 }
 
 Text lightgray(Text&& text) {
-    return COLORIZE(248, text);
+    return LightGray(text);
 }
 
 Text lightestgray(Text&& text) {
-    return COLORIZE(250, text);
+    return LightestGray(text);
 }
 
 Text darkgray(Text&& text) {
-    return COLORIZE(240, text);
+    return DarkGray(text);
 }
 
 Text darkestgray(Text&& text) {
-    return COLORIZE(238, text);
+    return DarkestGray(text);
 }
 
-} // namespace Tui
\ No newline at end of file
+} // namespace Tui
@@ -1,8 +1,11 @@
 #include "tui/factory.h"
 #include "tui/block.h"
 #include "tui/divider.h"
+#include "tui/fileblock.h"
 #include "tui/hlayout.h"
+#include "tui/logblock.h"
 #include "tui/text.h"
+#include "tui/virtualblock.h"
 #include "tui/vlayout.h"
 
 namespace Tui {
@@ -21,4 +24,17 @@ std::unique_ptr<VLayout> make_vertical_layout() {
 std::unique_ptr<Divider> make_divider(Text&& text) {
     return std::make_unique<Divider>(std::move(text));
 }
+
+std::unique_ptr<VirtualBlock> make_virtual_block(uint32_t count, std::function<void(uint32_t, Text&)> provider,
+                                                 std::optional<uint32_t> width) {
+    return std::make_unique<VirtualBlock>(count, std::move(provider), width);
+}
+
+std::unique_ptr<LogBlock> make_log_block(uint32_t capacity, std::optional<uint32_t> width) {
+    return std::make_unique<LogBlock>(capacity, width);
+}
+
+std::unique_ptr<FileBlock> make_file_block(std::optional<uint32_t> width) {
+    return std::make_unique<FileBlock>(width);
+}
 } // namespace Tui
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include "tui/fileblock.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Tui {
+FileBlock::FileBlock(std::optional<uint32_t> width) :
+    Node(Node::Type::FileBlock),
+    width(width) {
+}
+
+FileBlock::~FileBlock() {
+    close();
+}
+
+bool FileBlock::open(const std::string& path) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat st {};
+    if (fd < 0 || ::fstat(fd, &st) != 0 || (st.st_size > 0 && !map(static_cast<size_t>(st.st_size)))) {
+        int error = errno;
+        close();
+        errno = error;
+        return false;
+    }
+    size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void FileBlock::close() {
+    unmap();
+    if (fd >= 0) {
+        ::close(fd);
+        fd = -1;
+    }
+    size = 0;
+    starts.assign(1, 0);
+    indexed = 0;
+    touch();
+}
+
+bool FileBlock::index(size_t bytes) {
+    uint32_t lines = count();
+
+    const char* p = data + indexed;
+    const char* end = data + (size - indexed > bytes ? indexed + bytes : size);
+    while (p < end) {
+        const auto* newline = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!newline) {
+            break;
+        }
+        p = newline + 1;
+        starts.push_back(static_cast<uint64_t>(p - data));
+    }
+    indexed = static_cast<size_t>(end - data);
+
+    if (count() != lines) {
+        touch();
+    }
+    return indexed == size;
+}
+
+bool FileBlock::update(size_t bytes) {
+    // The last line is not counted anymore once the file grows, until it is indexed again
+    uint32_t lines = count();
+
+    struct stat st {};
+    if (fd >= 0 && ::fstat(fd, &st) == 0) {
+        // The file only grows (see FileBlock): a smaller size is not taken into account.
+        // It is mapped with room to grow, so that it is not mapped again at each update
+        auto length = static_cast<size_t>(st.st_size);
+        if (length > size && (length <= mapped || map(length + length / 2))) {
+            size = length;
+        }
+    }
+
+    bool indexed_all = index(bytes);
+    if (count() != lines) {
+        touch();
+    }
+    return indexed_all;
+}
+
+uint32_t FileBlock::count() const {
+    auto lines = static_cast<uint32_t>(starts.size() - 1);
+    // Last line without a newline
+    return indexed == size && starts.back() < size ? lines + 1 : lines;
+}
+
+std::string_view FileBlock::line(uint32_t index) const {
+    size_t begin = starts[index];
+    size_t end = index + 1 < starts.size() ? starts[index + 1] - 1 : size;
+    if (end > begin && data[end - 1] == '\r') {
+        end--;
+    }
+    return {data + begin, end - begin};
+}
+
+void FileBlock::append_line(uint32_t index, Text& text) const {
+    text.append(line(index));
+}
+
+MemoryUsage FileBlock::memory_usage() const {
+    MemoryUsage usage;
+    usage.add_object(sizeof(FileBlock));
+    usage.nodes = 1;
+    usage.add_storage(starts);
+    return usage;
+}
+
+bool FileBlock::map(size_t length) {
+    // The previous mapping is kept if the file cannot be mapped
+    void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    unmap();
+    data = static_cast<const char*>(address);
+    mapped = length;
+    return true;
+}
+
+void FileBlock::unmap() {
+    if (data) {
+        ::munmap(const_cast<char*>(data), mapped);
+        data = nullptr;
+        mapped = 0;
+    }
+}
+} // namespace Tui
@@ -0,0 +1,378 @@
+#include "tui/layout.h"
+#include "tui/block.h"
+#include "tui/container.h"
+#include "tui/divider.h"
+#include "tui/fileblock.h"
+#include "tui/logblock.h"
+#include "tui/virtualblock.h"
+#include <algorithm>
+
+namespace Tui {
+// Whether the node is a Container, whose children are walked
+// (a flattened root is laid out as an empty layout instead).
+static bool is_container(const Node& node) {
+    return node.type == Node::Type::HLayout || node.type == Node::Type::VLayout;
+}
+
+// Whether the child is walked (a flattened root in a container is left out).
+static bool is_walked(const std::unique_ptr<Node>& child) {
+    return child->type != Node::Type::Flattened;
+}
+
+Layout::Type::BoxType Layout::box_type(const Node& node, const Node* parent) {
+    if (node.type == Node::Type::Block)
+        return Layout::Type::Block;
+    if (node.type == Node::Type::HLayout)
+        return Layout::Type::HLayout;
+    if (node.type == Node::Type::VLayout)
+        return Layout::Type::VLayout;
+    if (node.type == Node::Type::VirtualBlock)
+        return Layout::Type::VirtualBlock;
+    if (node.type == Node::Type::LogBlock)
+        return Layout::Type::LogBlock;
+    if (node.type == Node::Type::FileBlock)
+        return Layout::Type::FileBlock;
+    if (node.type == Node::Type::Flattened)
+        return Layout::Type::VLayout;
+    // Dividers span the direction of their layout
+    if (parent && parent->type == Node::Type::HLayout)
+        return Layout::Type::HDivider;
+    return Layout::Type::VDivider;
+}
+
+void Layout::update(const Node& root, bool retained, Flatten flatten) {
+    build(root, retained, flatten);
+    measure();
+    arrange();
+}
+
+void Layout::build(const Node& root, bool retained, Flatten flatten) {
+    if (!flatten) {
+        if (!retained || boxes.empty() || flattened || !sync(root)) {
+            rebuild(root);
+        }
+        return;
+    }
+
+    if (!retained || boxes.empty() || flattened != flatten || boxes[0].node != &root) {
+        boxes.clear();
+        flatten(root, boxes);
+        flattened = flatten;
+
+        dirty.clear();
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            dirty.push_back(i);
+        }
+    } else {
+        sync_versions();
+    }
+}
+
+uint32_t Layout::measured() const {
+    return static_cast<uint32_t>(dirty.size());
+}
+
+uint32_t Layout::rows() const {
+    return boxes.empty() ? 0 : boxes[0].bottom;
+}
+
+MemoryUsage Layout::memory_usage() const {
+    MemoryUsage usage;
+    usage.add_object(sizeof(Layout));
+    usage.add_storage(boxes);
+    usage.add_storage(dirty);
+    usage.add_storage(stack);
+    return usage;
+}
+
+bool Layout::sync(const Node& root) {
+    // Visit the boxes of the modified nodes, checking that
+    // the structure of the tree did not change meanwhile.
+    dirty.clear();
+
+    if (boxes[0].node != &root || boxes[0].type != box_type(root, nullptr)) {
+        return false;
+    }
+
+    stack.clear();
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+        uint32_t i = stack.back();
+        stack.pop_back();
+
+        Box& box = boxes[i];
+        if (box.version == box.node->version) {
+            // Nothing changed in this subtree since the last layout
+            continue;
+        }
+
+        box.version = box.node->version;
+        box.dirty = true;
+        dirty.push_back(i);
+
+        if (is_container(*box.node)) {
+            const auto& children = static_cast<const Container*>(box.node)->children;
+            auto first_child = static_cast<uint32_t>(stack.size());
+            uint32_t k = 0;
+            for (uint32_t j = i + 1; j < box.end; j = boxes[j].end, k++) {
+                while (k < children.size() && !is_walked(children[k])) {
+                    k++;
+                }
+                if (k >= children.size() || boxes[j].node != &*children[k] ||
+                    boxes[j].type != box_type(*children[k], box.node)) {
+                    return false;
+                }
+                stack.push_back(j);
+            }
+            while (k < children.size() && !is_walked(children[k])) {
+                k++;
+            }
+            if (k != children.size()) {
+                return false;
+            }
+            // Visit the children in pre-order
+            std::reverse(stack.begin() + first_child, stack.end());
+        }
+    }
+
+    return true;
+}
+
+void Layout::sync_versions() {
+    // The structure is known to be the same: only the versions are checked
+    dirty.clear();
+
+    uint32_t i = 0;
+    while (i < boxes.size()) {
+        Box& box = boxes[i];
+        if (box.version == box.node->version) {
+            // Nothing changed in this subtree since the last layout
+            i = box.end;
+            continue;
+        }
+
+        box.version = box.node->version;
+        box.dirty = true;
+        dirty.push_back(i);
+        i++;
+    }
+}
+
+void Layout::rebuild(const Node& root) {
+    boxes.clear();
+    dirty.clear();
+    flattened = nullptr;
+
+    const auto push_box = [this](const Node& node, const Node* parent) {
+        Box box {};
+        box.node = &node;
+        box.type = box_type(node, parent);
+        box.version = node.version;
+        dirty.push_back(static_cast<uint32_t>(boxes.size()));
+        boxes.push_back(box);
+    };
+
+    // The stack holds the containers being visited: for each container, the index
+    // of its box is followed by the index of the next child to visit.
+    push_box(root, nullptr);
+    stack.clear();
+    stack.push_back(0);
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+        uint32_t i = stack[stack.size() - 2];
+        uint32_t k = stack.back();
+        const Node& node = *boxes[i].node;
+
+        if (is_container(node) && k < static_cast<const Container&>(node).children.size()) {
+            stack.back()++;
+            if (!is_walked(static_cast<const Container&>(node).children[k])) {
+                continue;
+            }
+            auto child = static_cast<uint32_t>(boxes.size());
+            push_box(*static_cast<const Container&>(node).children[k], &node);
+            stack.push_back(child);
+            stack.push_back(0);
+        } else {
+            boxes[i].end = static_cast<uint32_t>(boxes.size());
+            stack.pop_back();
+            stack.pop_back();
+        }
+    }
+}
+
+void Layout::measure() {
+    // Compute dimensions of nodes with fixed size and propagate
+    // information up to all the tree (e.g. to containers).
+    // Boxes are measured in reverse pre-order: children before their parent.
+    for (auto it = dirty.rbegin(); it != dirty.rend(); it++) {
+        Box& box = boxes[*it];
+
+        box.measured_width = std::nullopt;
+        box.measured_height = std::nullopt;
+
+        if (box.type & Type::Block) {
+            const auto& block = static_cast<const Block&>(*box.node);
+
+            // Do not take ending empty lines into account for block's height
+            int32_t h = static_cast<int32_t>(block.lines.size()) - 1;
+            while (h >= 0 && block.lines[h].size() == 0) {
+                h--;
+            }
+            auto lines = static_cast<uint32_t>(h + 1);
+            box.measured_height = block.height.value_or(lines - std::min(block.offset, lines));
+
+            if (block.width) {
+                // Fixed width
+                box.measured_width = *block.width;
+            } else {
+                // Variable width (none for a block without lines)
+                box.measured_width = 0;
+                for (const auto& l : block.lines) {
+                    box.measured_width = std::max(*box.measured_width, l.size().value);
+                }
+            }
+        } else if (box.type & Type::VirtualBlock) {
+            // Lines are not measured: they are produced only when presented
+            const auto& block = static_cast<const VirtualBlock&>(*box.node);
+            box.measured_height = block.height.value_or(block.count - std::min(block.offset, block.count));
+            // Variable width: none, as a block without lines (the block fills the space left, if any)
+            box.measured_width = block.width.value_or(0);
+        } else if (box.type & Type::LogBlock) {
+            // Lines are not measured either: a log block presents its last lines in the given space
+            const auto& block = static_cast<const LogBlock&>(*box.node);
+            box.measured_height = block.height.value_or(block.presented());
+            box.measured_width = block.width.value_or(0);
+        } else if (box.type & Type::FileBlock) {
+            // Nor are the lines of a file: only the indexed ones are counted
+            const auto& block = static_cast<const FileBlock&>(*box.node);
+            uint32_t lines = block.count();
+            box.measured_height = block.height.value_or(block.tail ? lines : lines - std::min(block.offset, lines));
+            box.measured_width = block.width.value_or(0);
+        } else if (box.type & Type::HDivider) {
+            box.measured_width = static_cast<const Divider&>(*box.node).text.size();
+        } else if (box.type & Type::VDivider) {
+            box.measured_height = 1;
+        } else if (box.type & Type::HLayout) {
+            box.first_rows = 1;
+            for (uint32_t j = *it + 1; j < box.end; j = boxes[j].end) {
+                const Box& child = boxes[j];
+                box.measured_width = box.measured_width.value_or(0) + child.measured_width.value_or(0);
+                box.measured_height = std::max(box.measured_height.value_or(0), child.measured_height.value_or(0));
+                box.first_rows = std::max(box.first_rows, child.first_rows);
+            }
+        } else if (box.type & Type::VLayout) {
+            box.first_rows = 1;
+            for (uint32_t j = *it + 1; j < box.end; j = boxes[j].end) {
+                const Box& child = boxes[j];
+                box.measured_width = std::max(box.measured_width.value_or(0), child.measured_width.value_or(0));
+                box.measured_height = box.measured_height.value_or(0) + child.measured_height.value_or(0);
+                // Only the first child starts at the first row
+                box.first_rows = j == *it + 1 ? child.first_rows : box.first_rows + child.measured_height.value_or(0);
+            }
+        }
+
+        if (box.type & Type::Content) {
+            box.first_rows = std::max(box.measured_height.value_or(0), 1U);
+        }
+    }
+}
+
+void Layout::arrange() {
+    // Arrange the boxes top-down:
+    // - Propagate dimensions down to automatically sized nodes (e.g. dividers).
+    // - Update block's width to fill containers space.
+    //   This applies to:
+    //   * All the blocks of vertical layouts.
+    //   * Last blocks of horizontal layouts.
+    // - Assign the rows to the nodes.
+    // - Find ending blocks (the ones at the right of the entire content)
+    //   An ending block is defined by the following rule:
+    //   A block is an ending block unless it is not part of the rightmost
+    //   branch of any Horizontal Layout ancestors it has.
+    // A subtree that has not been modified is not visited again
+    // if the space assigned to it did not change either.
+
+    // Row at which the content of a node starting at the given row ends.
+    const auto end_row = [](const Box& box, uint32_t top) {
+        if (box.type & Type::Content) {
+            return top == 0 ? std::max(box.height, 1U) : top + box.height;
+        }
+        return top == 0 ? box.first_rows : top + box.measured_height.value_or(0);
+    };
+
+    Box& root = boxes[0];
+    root.auto_width = root.measured_width.value_or(0);
+    root.height = root.measured_height.value_or(0);
+    root.x = 0;
+    root.width = root.auto_width;
+    root.top = 0;
+    root.end_row = end_row(root, 0);
+    root.bottom = root.end_row;
+    root.ending = true;
+    root.pending = true;
+
+    uint32_t i = 0;
+    while (i < boxes.size()) {
+        Box& box = boxes[i];
+        if (!box.pending && !box.dirty) {
+            i = box.end;
+            continue;
+        }
+
+        box.pending = false;
+        box.dirty = false;
+
+        if (box.type & Type::Container) {
+            uint32_t x = box.x;
+            uint32_t top = box.top;
+
+            for (uint32_t j = i + 1; j < box.end; j = boxes[j].end) {
+                Box& child = boxes[j];
+                bool last = child.end == box.end;
+
+                bool changed = false;
+                const auto assign = [&changed](auto& field, auto value) {
+                    if (field != value) {
+                        field = value;
+                        changed = true;
+                    }
+                };
+
+                assign(child.auto_width, child.measured_width.value_or(box.auto_width));
+                assign(child.height, child.measured_height.value_or(box.height));
+                assign(child.x, x);
+
+                if (box.type & Type::HLayout) {
+                    // The children are presented in parallel.
+                    // The last child fills the remaining horizontal layout width.
+                    // Only the blocks of the right most branch are candidates for ending blocks.
+                    assign(child.width, last ? box.width - std::min(box.width, x - box.x) : child.auto_width);
+                    assign(child.top, box.top);
+                    assign(child.end_row, end_row(child, box.top));
+                    assign(child.bottom, box.bottom);
+                    assign(child.ending, box.ending && last);
+                    x += child.width;
+                } else {
+                    // The children are presented sequentially: each child starts when the content
+                    // of the previous one ends. The last one fills the remaining rows.
+                    // All the children fills the entire the vertical layout width
+                    assign(child.width, box.width);
+                    assign(child.top, top);
+                    assign(child.end_row, end_row(child, top));
+                    assign(child.bottom, last ? box.bottom : std::max(top, child.end_row));
+                    assign(child.ending, box.ending);
+                    top = child.end_row;
+                }
+
+                if (changed) {
+                    child.pending = true;
+                }
+            }
+        }
+
+        i++;
+    }
+}
+} // namespace Tui
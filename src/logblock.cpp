@@ -0,0 +1,215 @@
+#include "tui/logblock.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Tui {
+LogBlock::LogBlock(uint32_t capacity, std::optional<uint32_t> width) :
+    Node(Node::Type::LogBlock),
+    width(width),
+    ring(std::max(capacity, 1U)) {
+}
+
+LogBlock& LogBlock::operator<<(const Text& text) {
+    // Split text in lines by \n
+    uint32_t i = 0;
+
+    std::optional<Text::RawIndex> new_line_index;
+    do {
+        new_line_index = text.find('\n', Text::RawIndex {i});
+        if (new_line_index) {
+            back().append(text, i, *new_line_index);
+            new_line();
+            i = *new_line_index + 1;
+        }
+    } while (new_line_index);
+
+    back().append(text, i, text.count);
+
+    touch();
+
+    return *this;
+}
+
+LogBlock& LogBlock::operator<<(Text&& text) {
+    Text& line = back();
+    if (line.count == 0 && !text.find('\n')) {
+        std::swap(line, text);
+        text.clear();
+        touch();
+        return *this;
+    }
+    return *this << static_cast<const Text&>(text);
+}
+
+LogBlock& LogBlock::operator<<(std::string_view str) {
+    // Split str in lines by \n
+    while (const auto* end = static_cast<const char*>(std::memchr(str.data(), '\n', str.size()))) {
+        auto n = static_cast<size_t>(end - str.data());
+        back().append(str.substr(0, n));
+        new_line();
+        str.remove_prefix(n + 1);
+    }
+
+    back().append(str);
+
+    touch();
+
+    return *this;
+}
+
+LogBlock& LogBlock::operator<<(const std::string& str) {
+    return *this << std::string_view {str};
+}
+
+LogBlock& LogBlock::operator<<(const char* str) {
+    return *this << std::string_view {str};
+}
+
+LogBlock& LogBlock::operator<<(LogBlock& (*manip)(LogBlock&)) {
+    return manip(*this);
+}
+
+LogBlock& LogBlock::operator<<(const Number& number) {
+    back() += number;
+    touch();
+    return *this;
+}
+
+void LogBlock::clear() {
+    first = 0;
+    lines = 0;
+    touch();
+}
+
+void LogBlock::new_line() {
+    if (lines < ring.size()) {
+        lines++;
+    } else {
+        // The oldest line becomes the newest one
+        first = first + 1 < ring.size() ? first + 1 : 0;
+        discarded_lines++;
+    }
+    ring[slot(lines - 1)].clear();
+}
+
+Text& LogBlock::back() {
+    // No lines yet: add one
+    if (lines == 0) {
+        new_line();
+    }
+    return ring[slot(lines - 1)];
+}
+
+MemoryUsage LogBlock::memory_usage() const {
+    MemoryUsage usage;
+    usage.add_object(sizeof(LogBlock));
+    usage.nodes = 1;
+
+    usage.add_storage(ring);
+    for (uint32_t i = 0; i < lines; i++) {
+        usage.add_stored(line(i).memory_usage(), sizeof(Text));
+    }
+
+    // The other lines of the ring are only kept for later: their storage is reserved, not used
+    MemoryUsage spare_usage;
+    for (uint32_t i = lines; i < ring.size(); i++) {
+        spare_usage.add_stored(line(i).memory_usage(), sizeof(Text));
+    }
+    usage.reserved += spare_usage.reserved;
+    usage.allocations += spare_usage.allocations;
+
+    return usage;
+}
+
+LogBlock& endl(LogBlock& b) {
+    b.new_line();
+    b.touch();
+    return b;
+}
+
+LogBlock& operator<<(const std::unique_ptr<LogBlock>& block, LogBlock& (*manip)(const std::unique_ptr<LogBlock>&)) {
+    return manip(block);
+}
+
+LogBlock& endl(const std::unique_ptr<LogBlock>& b) {
+    return endl(*b);
+}
+
+namespace {
+    uint64_t ceil_power_of_two(uint32_t n) {
+        uint64_t power = 1;
+        while (power < n) {
+            power *= 2;
+        }
+        return power;
+    }
+} // namespace
+
+LogQueue::LogQueue(uint32_t capacity) :
+    slots(ceil_power_of_two(capacity)),
+    mask {slots.size() - 1} {
+}
+
+bool LogQueue::push(std::string_view line) {
+    Text* slot = acquire();
+    if (!slot) {
+        return false;
+    }
+    slot->append(line);
+    publish();
+    return true;
+}
+
+bool LogQueue::push(const std::string& line) {
+    return push(std::string_view {line});
+}
+
+bool LogQueue::push(const char* line) {
+    return push(std::string_view {line});
+}
+
+bool LogQueue::push(const Text& line) {
+    Text* slot = acquire();
+    if (!slot) {
+        return false;
+    }
+    *slot += line;
+    publish();
+    return true;
+}
+
+Text* LogQueue::acquire() {
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    if (t - cached_head == slots.size()) {
+        // Full, unless the consumer has drained lines since the last check
+        cached_head = head.load(std::memory_order_acquire);
+        if (t - cached_head == slots.size()) {
+            dropped_lines.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+    }
+    Text* slot = &slots[t & mask];
+    slot->clear();
+    return slot;
+}
+
+void LogQueue::publish() {
+    tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+uint32_t LogQueue::drain(LogBlock& block) {
+    uint64_t h = head.load(std::memory_order_relaxed);
+    uint64_t t = tail.load(std::memory_order_acquire);
+    for (uint64_t i = h; i < t; i++) {
+        // The line is swapped with the block's new (empty) line:
+        // the slot gets the storage of a line discarded by the block
+        block << std::move(slots[i & mask]) << endl;
+        head.store(i + 1, std::memory_order_release);
+    }
+    return static_cast<uint32_t>(t - h);
+}
+
+uint64_t LogQueue::dropped() const {
+    return dropped_lines.load(std::memory_order_relaxed);
+}
+} // namespace Tui
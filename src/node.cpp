@@ -0,0 +1,25 @@
+#include "tui/node.h"
+#include <atomic>
+
+namespace Tui {
+namespace {
+    uint64_t next_version() {
+        // Versions are never reused, so that a node allocated at the address
+        // of a destroyed one is never mistaken for it.
+        static std::atomic<uint64_t> version {};
+        return ++version;
+    }
+} // namespace
+
+Node::Node(Type type) :
+    type {type},
+    version {next_version()} {
+}
+
+void Node::touch() {
+    uint64_t v = next_version();
+    for (Node* node = this; node; node = node->parent) {
+        node->version = v;
+    }
+}
+} // namespace Tui
@@ -1,113 +1,660 @@
 #include "tui/presenter.h"
 #include "tui/block.h"
-#include "tui/decorators.h"
 #include "tui/divider.h"
-#include "tui/hlayout.h"
-#include "tui/vlayout.h"
-#include <iostream>
+#include "tui/fileblock.h"
+#include "tui/logblock.h"
+#include "tui/sgr.h"
+#include "tui/threadpool.h"
+#include "tui/virtualblock.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
 
 namespace Tui {
-Presenter::Presenter(std::ostream& os) :
-    os {os} {
+constexpr std::string_view SynchronizedUpdateBegin = "\033[?2026h";
+constexpr std::string_view SynchronizedUpdateEnd = "\033[?2026l";
+
+// Minimum number of rows presented by a thread.
+constexpr uint32_t MinBandRows = 64;
+
+#ifdef TUI_STATS
+constexpr bool StatsAvailable = true;
+#else
+constexpr bool StatsAvailable = false;
+#endif
+
+// Measures the time elapsed between consecutive laps.
+// A disabled stopwatch never reads the clock.
+class Stopwatch {
+public:
+    explicit Stopwatch(bool enabled) :
+        enabled {enabled} {
+        if (enabled) {
+            last = std::chrono::steady_clock::now();
+        }
+    }
+
+    // Nanoseconds elapsed since the previous lap (0 if disabled).
+    uint64_t lap() {
+        if (!enabled) {
+            return 0;
+        }
+        auto now = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+        last = now;
+        return static_cast<uint64_t>(elapsed);
+    }
+
+private:
+    bool enabled;
+    std::chrono::steady_clock::time_point last {};
+};
+
+// Number of SGR escape sequences ("\033[<parameters>m") in the given output.
+static uint64_t count_sgr(std::string_view out) {
+    uint64_t n = 0;
+    for (size_t i = out.find('\033'); i != std::string_view::npos; i = out.find('\033', i + 1)) {
+        size_t j = i + 1;
+        if (j >= out.size() || out[j] != '[') {
+            continue;
+        }
+        do {
+            j++;
+        } while (j < out.size() && ((out[j] >= '0' && out[j] <= '9') || out[j] == ';'));
+        if (j < out.size() && out[j] == 'm') {
+            n++;
+        }
+    }
+    return n;
 }
 
-struct PNode {
-    struct Type {
-        using PNodeType = uint8_t;
-        static constexpr PNodeType Block = 1 << 0;
-        static constexpr PNodeType HLayout = 1 << 1;
-        static constexpr PNodeType VLayout = 1 << 2;
-        static constexpr PNodeType HDivider = 1 << 3;
-        static constexpr PNodeType VDivider = 1 << 4;
-
-        static constexpr PNodeType Divider = HDivider | VDivider;
-        static constexpr PNodeType Content = Block | Divider;
-        static constexpr PNodeType Container = HLayout | VLayout;
-    };
+static const Text EmptyLine {};
+
+Presenter::Presenter(std::ostream& os, Mode mode) :
+    stream_sink {std::make_unique<StreamSink>(os)},
+    sink {*stream_sink},
+    mode {mode} {
+}
 
-    explicit PNode(Type::PNodeType type, const Node& node, PNode* parent) :
-        type(type),
-        node(node),
-        parent(parent) {
+Presenter::Presenter(Sink& sink, Mode mode) :
+    sink {sink},
+    mode {mode} {
+}
+
+// Appends the escape sequence moving the cursor to the given position (1-based).
+static void move_cursor(std::string& buffer, uint32_t row, uint32_t column) {
+    buffer += "\033[";
+    append_parameter(buffer, row);
+    buffer += ';';
+    append_parameter(buffer, column);
+    buffer += 'H';
+}
+
+// Presents the line through the tokens of the target,
+// truncated/expanded to exactly fill the given width (as Text::substr() and Text::rpad() do):
+// a wide character that does not fit in the last column is replaced by a space.
+template <typename Target>
+void present_line(Target& target, const Text& t, uint32_t width) {
+    if (t.size() <= width) {
+        target.text(t);
+        target.fill(width - t.size());
+        return;
     }
 
-    Type::PNodeType type;
-    const Node& node;
-    PNode* parent {};
+    uint32_t n = 0;
+    bool truncated = false;
+    t.for_each([&target, &n, &truncated, width](std::string_view token, uint32_t size) {
+        truncated = truncated || n >= width || size > width - n;
+        if (!truncated) {
+            n += size;
+            target.token(token, size);
+        }
+    });
+    target.fill(width - n);
+}
+
+// Writes the presented content to a buffer.
+struct StreamTarget {
+    void text(const Text& t) {
+        buffer += t.view();
+    }
 
-    std::optional<uint32_t> width {};
-    std::optional<uint32_t> height {};
+    // Writes the line truncated/expanded to exactly fill the given width.
+    void line(const Text& t, uint32_t width) {
+        if (t.size() < width) {
+            buffer += t.view();
+            fill(width - t.size());
+        } else if (t.size() > width) {
+            Text::Length columns {};
+            buffer += t.view(Text::Length {width}, columns);
+            fill(width - columns);
+        } else {
+            buffer += t.view();
+        }
+    }
 
-    bool done {};
-};
+    void reset() {
+        buffer += ResetSgr;
+    }
 
-struct PContent : PNode {
-    PContent(Type::PNodeType type, const Node& node, PNode* parent) :
-        PNode {type, node, parent} {
+    void token(std::string_view token, uint32_t) {
+        buffer += token;
     }
 
-    bool endl {};
-    uint32_t line {};
-};
+    void fill(uint32_t n) {
+        buffer.append(n, ' ');
+    }
 
-struct PBlock : PContent {
-    PBlock(const Block& node, PNode* parent) :
-        PContent {Type::Block, node, parent},
-        node {node} {
+    void endl() {
+        buffer += '\n';
     }
 
-    const Block& node;
+    std::string& buffer;
 };
 
-struct PDivider : PContent {
-    PDivider(Type::PNodeType type, const Divider& node, PNode* parent) :
-        PContent {type, node, parent},
-        node {node} {
+// Writes the presented content to a buffer, interpreting the SGR escape sequences:
+// the style of the terminal is changed only before writing characters of another
+// style, with the shortest sequence possible.
+// A SGR sequence the style does not represent (see Style::apply()) is written as is:
+// the next ones are then written as is too, until the terminal is reset.
+struct SgrStreamTarget {
+    void text(const Text& t) {
+        // Plain characters share the same style: they are written at once
+        t.for_each_chunk([this](std::string_view chunk, uint32_t size) {
+            token(chunk, size);
+        });
     }
 
-    const Divider& node;
-};
+    void line(const Text& t, uint32_t width) {
+        if (t.size() <= width) {
+            text(t);
+            fill(width - t.size());
+            return;
+        }
 
-struct PHDivider : PDivider {
-    PHDivider(const Divider& node, PNode* parent) :
-        PDivider {Type::HDivider, node, parent} {
+        // As present_line(), cutting sequences of plain characters at once
+        uint32_t n = 0;
+        bool truncated = false;
+        t.for_each_chunk([this, &n, &truncated, width](std::string_view chunk, uint32_t size) {
+            if (!truncated && n < width && chunk.size() == size && size > width - n) {
+                size = width - n;
+                chunk = chunk.substr(0, size);
+            }
+            truncated = truncated || n >= width || size > width - n;
+            if (!truncated) {
+                n += size;
+                token(chunk, size);
+            }
+        });
+        fill(width - n);
     }
-};
 
-struct PVDivider : PDivider {
-    PVDivider(const Divider& node, PNode* parent) :
-        PDivider {Type::VDivider, node, parent} {
+    void reset() {
+        style = {};
+        resetting = extended;
     }
-};
 
-struct PContainer : PNode {
-    PContainer(Type::PNodeType type, const Container& node, PNode* parent) :
-        PNode {type, node, parent},
-        node {node} {
+    void token(std::string_view token, uint32_t size) {
+        if (size == 0 && !extended && style.apply(token)) {
+            return;
+        }
+        sync();
+        buffer += token;
+        if (size == 0 && token.size() > 2 && token[1] == '[' && token.back() == 'm') {
+            if (style.apply(token)) {
+                current = style;
+                extended = extended && token != ResetSgr;
+            } else {
+                extended = true;
+            }
+        }
     }
 
-    const Container& node;
-    std::vector<std::unique_ptr<PNode>> children;
-};
+    void fill(uint32_t n) {
+        if (n > 0) {
+            sync();
+            buffer.append(n, ' ');
+        }
+    }
 
-struct PHLayout : PContainer {
-    PHLayout(const HLayout& node, PNode* parent) :
-        PContainer {Type::HLayout, node, parent},
-        node {node} {
+    void endl() {
+        // The attributes not represented are not left to the next rows
+        if (resetting) {
+            sync();
+        }
+        buffer += '\n';
     }
 
-    const HLayout& node;
+    // Leaves the terminal in its default style.
+    void finish() {
+        reset();
+        sync();
+    }
+
+    void sync() {
+        if (resetting) {
+            buffer += ResetSgr;
+            current = {};
+            extended = resetting = false;
+        }
+        if (style != current) {
+            style.sgr(buffer, current);
+            current = style;
+        }
+    }
+
+    std::string& buffer;
+    // Style of the next characters.
+    Style style {};
+    // Style of the terminal.
+    Style current {};
+    // The terminal may have attributes not represented by its style (set by a sequence written as is).
+    bool extended {};
+    // The terminal is to be reset before the next characters, to remove them.
+    bool resetting {};
 };
 
-struct PVLayout : PContainer {
-    PVLayout(const VLayout& node, PNode* parent) :
-        PContainer {Type::VLayout, node, parent},
-        node {node} {
+// Writes the presented content to the cells of a surface, row after row,
+// interpreting the SGR escape sequences as a terminal would.
+// Content exceeding the width of the surface is clipped (see Surface for what a cell keeps).
+struct CellTarget {
+    void text(const Text& t) {
+        t.for_each([this](std::string_view token, uint32_t size) {
+            this->token(token, size);
+        });
+    }
+
+    void line(const Text& t, uint32_t width) {
+        present_line(*this, t, width);
+    }
+
+    void reset() {
+        style.apply(ResetSgr);
+    }
+
+    void token(std::string_view token, uint32_t size) {
+        if (size > 0) {
+            put(Cell::glyph_of(token), size);
+        } else if (!style.apply(token) && token[0] != '\033') {
+            attach(token);
+        }
+    }
+
+    // Appends a zero width character (e.g. a combining mark) to the glyph
+    // of the last cell written in the row, if its bytes fit.
+    void attach(std::string_view token) {
+        if (last == NoCell) {
+            return;
+        }
+        Cell::Glyph& glyph = surface.cells[last].glyph;
+        size_t n = surface.cells[last].glyph_str().size();
+        if (token.size() <= glyph.size() - n) {
+            std::copy(token.begin(), token.end(), glyph.begin() + n);
+        }
+    }
+
+    void fill(uint32_t n) {
+        for (uint32_t i = 0; i < n; i++) {
+            put(Cell::Glyph {' '}, 1);
+        }
+    }
+
+    void endl() {
+        x = 0;
+        y++;
+        last = NoCell;
     }
 
-    const VLayout& node;
+    void put(Cell::Glyph glyph, uint32_t size) {
+        uint32_t width = surface.width;
+        if (x < width) {
+            if (surface.cells.size() < (y + 1) * width) {
+                surface.cells.resize((y + 1) * width);
+            }
+            Cell* row = &surface.cells[y * width];
+            row[x] = {glyph, style};
+            for (uint32_t i = 1; i < size && x + i < width; i++) {
+                row[x + i] = {Cell::Glyph {}, style};
+            }
+            last = y * width + x;
+        } else {
+            last = NoCell;
+        }
+        x += size;
+    }
+
+    static constexpr uint32_t NoCell = UINT32_MAX;
+
+    Surface& surface;
+    uint32_t x {};
+    uint32_t y {};
+    // Index of the last cell written in the row.
+    uint32_t last {NoCell};
+    Style style {};
 };
 
+// Area of the frame to present: rows [top, bottom) and columns [left, right).
+struct Clip {
+    uint32_t top {};
+    uint32_t bottom {UINT32_MAX};
+    uint32_t left {};
+    uint32_t right {UINT32_MAX};
+};
+
+// Area of the frame covered by the viewport (the whole frame if none).
+static Clip make_clip(const std::optional<Presenter::Viewport>& viewport) {
+    if (!viewport) {
+        return {};
+    }
+    const auto end = [](uint32_t position, uint32_t size) {
+        return size > UINT32_MAX - position ? UINT32_MAX : position + size;
+    };
+    return {viewport->y, end(viewport->y, viewport->height), viewport->x, end(viewport->x, viewport->width)};
+}
+
+// Presents the columns [clip.left, clip.right) of a content of the given width starting
+// at the given column, made of the given text truncated/expanded as by Target::line().
+// Columns of wide glyphs crossing the edges of the clip are filled with spaces.
+template <typename Target>
+void present_clipped(Target& target, const Text& t, uint32_t x, uint32_t width, const Clip& clip) {
+    const auto fill = [&target, &clip](uint32_t begin, uint32_t end) {
+        begin = std::max(begin, clip.left);
+        end = std::min(end, clip.right);
+        if (begin < end) {
+            target.fill(end - begin);
+        }
+    };
+
+    // As present_line(), a wide character that does not fit in the last column is not presented
+    bool truncating = t.size() > width;
+    bool truncated = false;
+    uint32_t n = 0;
+    t.for_each([&](std::string_view token, uint32_t size) {
+        uint32_t c = x + n;
+        truncated = truncated || (truncating && (n >= width || size > width - n));
+        if (truncated) {
+            return;
+        }
+        n += size;
+        if (size == 0) {
+            // Escape sequences are kept (even outside the clip)
+            // so that the style of the visible content is the same
+            target.token(token, size);
+        } else if (c >= clip.left && c + size <= clip.right) {
+            target.token(token, size);
+        } else {
+            fill(c, c + size);
+        }
+    });
+
+    if (n < width) {
+        fill(x + n, x + width);
+    }
+}
+
+// Whether a box is entirely inside the columns of the clip, or entirely outside.
+static bool inside_clip(const Layout::Box& box, const Clip& clip) {
+    return box.x >= clip.left && box.x + box.width <= clip.right;
+}
+
+static bool outside_clip(const Layout::Box& box, const Clip& clip) {
+    return !inside_clip(box, clip) && (box.x >= clip.right || box.x + box.width <= clip.left);
+}
+
+// Lists the content boxes visited by the rows of the clip, with the rows each one is visited in
+// (see present_rows()): the tree is walked once per frame, instead of once per row.
+//
+// [Container]
+//
+// - Horizontal Layout:
+//       Its children are presented in parallel, in the rows of the layout.
+// - Vertical Layout
+//       Its children are presented sequentially, each one in its own rows.
+//
+// A box is visited in its rows that are also rows of all its ancestors.
+// The boxes outside of the columns of the clip are not visited (nor their descendants),
+// unless they contain the ending content of their rows.
+static void plan_rows(const Layout& layout, const Clip& clip, Detail::RowPlan& plan) {
+    const auto& boxes = layout.boxes;
+    plan.top = std::min(layout.rows(), clip.top);
+    plan.bottom = std::min(layout.rows(), clip.bottom);
+    plan.spans.clear();
+    plan.ancestors.clear();
+
+    for (uint32_t i = 0; i < boxes.size();) {
+        const Layout::Box& box = boxes[i];
+        while (!plan.ancestors.empty() && i >= boxes[plan.ancestors.back().box].end) {
+            plan.ancestors.pop_back();
+        }
+
+        Detail::RowPlan::Span span {i, std::max(box.top, plan.top), std::min(box.bottom, plan.bottom)};
+        if (!plan.ancestors.empty()) {
+            span.top = std::max(span.top, plan.ancestors.back().top);
+            span.bottom = std::min(span.bottom, plan.ancestors.back().bottom);
+        }
+
+        if (span.top >= span.bottom || (outside_clip(box, clip) && !box.ending)) {
+            // Not visited: skip the whole subtree
+            i = box.end;
+            continue;
+        }
+
+        if (box.type & Layout::Type::Content) {
+            plan.spans.push_back(span);
+        } else {
+            plan.ancestors.push_back(span);
+        }
+        i++;
+    }
+
+    // Spans indexed by their first row (counting sort, keeping the pre-order)
+    uint32_t rows = plan.bottom - plan.top;
+    plan.first.assign(rows + 2, 0);
+    plan.ending.assign(rows + 1, 0);
+    for (const auto& span : plan.spans) {
+        plan.first[span.top - plan.top + 2]++;
+        plan.ending[span.bottom - plan.top]++;
+    }
+    for (uint32_t row = 2; row < rows + 2; row++) {
+        plan.first[row] += plan.first[row - 1];
+    }
+    plan.starting.resize(plan.spans.size());
+    for (uint32_t k = 0; k < plan.spans.size(); k++) {
+        plan.starting[plan.first[plan.spans[k].top - plan.top + 1]++] = k;
+    }
+}
+
+// Presents the content of a laid out tree, row by row, visiting the content boxes planned
+// for each row (see plan_rows()) from left to right. The spans presented by the current row
+// (active) are updated when spans start or end, rather than searched at each row.
+//
+// [Content]
+//
+// - Block/Dividers
+//       When it is visited it pushes the next line to the output stream.
+//       The lines are truncated/expanded to exactly fill the block's width.
+//       If there are no more lines to render, it pushes empty lines
+//       to fill the block's width.
+// - Virtual Block
+//       As a block, but the line is first produced (into the scratch text)
+//       by the provider of the block.
+// - Log Block
+//       As a block, presenting its last lines.
+// - File Block
+//       As a virtual block, the line being read from the mapped file.
+//
+// Only the rows and the columns inside the clip are presented:
+// the nodes crossing its edges are clipped.
+template <typename Target>
+void present_rows(const Layout& layout, const Detail::RowPlan& plan, Target& target, Text& scratch,
+                  std::vector<uint32_t>& active, const Clip& clip) {
+    const auto& boxes = layout.boxes;
+    const auto& spans = plan.spans;
+    uint32_t first_row = std::max(clip.top, plan.top);
+    uint32_t last_row = std::min(clip.bottom, plan.bottom);
+
+    // Spans of the first row
+    active.clear();
+    for (uint32_t k = 0; k < spans.size() && first_row < last_row; k++) {
+        if (spans[k].top <= first_row && first_row < spans[k].bottom) {
+            active.push_back(k);
+        }
+    }
+
+    for (uint32_t row = first_row; row < last_row; row++) {
+        if (row > first_row) {
+            uint32_t r = row - plan.top;
+            if (plan.ending[r] > 0) {
+                active.erase(std::remove_if(active.begin(), active.end(),
+                                            [&spans, row](uint32_t k) {
+                                                return spans[k].bottom == row;
+                                            }),
+                             active.end());
+            }
+
+            // Merges the spans starting at this row, from the back, keeping the pre-order
+            const uint32_t* starting = plan.starting.data() + plan.first[r];
+            auto m = plan.first[r + 1] - plan.first[r];
+            auto n = static_cast<uint32_t>(active.size());
+            active.resize(n + m);
+            while (m > 0) {
+                if (n > 0 && active[n - 1] > starting[m - 1]) {
+                    active[n + m - 1] = active[n - 1];
+                    n--;
+                } else {
+                    active[n + m - 1] = starting[m - 1];
+                    m--;
+                }
+            }
+        }
+
+        for (uint32_t k : active) {
+            const Layout::Box& box = boxes[spans[k].box];
+            bool inside = inside_clip(box, clip);
+            bool outside = outside_clip(box, clip);
+
+            if (!outside) {
+                // The line presented by a (virtual) block
+                const Text* line = nullptr;
+
+                if (row >= box.end_row) {
+                    // Nothing more to render: just fill the node space
+                } else if (box.type & Layout::Type::Block) {
+                    const auto& block = static_cast<const Block&>(*box.node);
+                    uint32_t index = block.offset + (row - box.top);
+                    line = index < block.lines.size() ? &block.lines[index] : &EmptyLine;
+                } else if (box.type & Layout::Type::VirtualBlock) {
+                    const auto& block = static_cast<const VirtualBlock&>(*box.node);
+                    uint32_t index = block.offset + (row - box.top);
+                    scratch.clear();
+                    if (index < block.count) {
+                        block.provider(index, scratch);
+                    }
+                    line = &scratch;
+                } else if (box.type & Layout::Type::LogBlock) {
+                    const auto& block = static_cast<const LogBlock&>(*box.node);
+                    uint32_t lines = block.presented();
+                    uint32_t index = lines - std::min(lines, block.height.value_or(lines)) + (row - box.top);
+                    line = index < lines ? &block.line(index) : &EmptyLine;
+                } else if (box.type & Layout::Type::FileBlock) {
+                    const auto& block = static_cast<const FileBlock&>(*box.node);
+                    uint32_t lines = block.count();
+                    uint32_t first = block.tail ? lines - std::min(lines, block.height.value_or(lines)) : block.offset;
+                    uint32_t index = first + (row - box.top);
+                    scratch.clear();
+                    if (index < lines) {
+                        block.append_line(index, scratch);
+                    }
+                    line = &scratch;
+                }
+
+                if (row >= box.end_row) {
+                    if (inside) {
+                        target.fill(box.width);
+                    } else {
+                        present_clipped(target, EmptyLine, box.x, box.width, clip);
+                    }
+                } else if (line) {
+                    // Present next line
+                    if (inside) {
+                        target.line(*line, box.width);
+                    } else {
+                        present_clipped(target, *line, box.x, box.width, clip);
+                    }
+
+                    // Always push the reset attribute in case the line has been truncated
+                    target.reset();
+                } else {
+                    const auto& divider = static_cast<const Divider&>(*box.node);
+                    uint32_t size = divider.text.size();
+
+                    if (size == 0) {
+                        // Nothing to repeat: blank
+                        if (inside) {
+                            target.fill(box.width);
+                        } else {
+                            present_clipped(target, EmptyLine, box.x, box.width, clip);
+                        }
+                    }
+                    for (uint32_t x = 0; size > 0 && x < box.width; x += size) {
+                        if (inside && size <= box.width - x) {
+                            target.text(divider.text);
+                        } else if (inside) {
+                            // The last repetition is truncated to the width of the divider
+                            target.line(divider.text, box.width - x);
+                            target.reset();
+                        } else {
+                            Clip divider_clip {clip.top, clip.bottom, clip.left,
+                                               std::min(clip.right, box.x + box.width)};
+                            present_clipped(target, divider.text, box.x + x, size, divider_clip);
+                        }
+                    }
+                }
+            }
+
+            // Go to a new line if this is an ending content
+            if (box.ending) {
+                target.endl();
+            }
+        }
+    }
+}
+
+Presenter::~Presenter() = default;
+
+void Presenter::set_output(Output o) {
+    output = o;
+    invalidate();
+}
+
+void Presenter::set_synchronized_update(bool enabled) {
+    synchronized_update = enabled;
+}
+
+void Presenter::set_threads(uint32_t threads) {
+    pool = threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+}
+
+void Presenter::set_minimal_sgr(bool enabled) {
+    minimal_sgr = enabled;
+}
+
+void Presenter::set_stats(bool enabled) {
+    collect_stats = enabled;
+}
+
+const Presenter::Stats& Presenter::stats() const {
+    return last_stats;
+}
+
+void Presenter::set_viewport(std::optional<Viewport> v) {
+    viewport = v;
+}
+
+void Presenter::invalidate() {
+    front = {};
+}
+
 void Presenter::present(const Node& root_node) {
     /*
      * Example of a layout with the associated tree.
@@ -138,333 +685,241 @@ void Presenter::present(const Node& root_node) {
      *     B2     B3            <----+
      */
 
-    std::unique_ptr<PNode> root;
-
-    // 1) First visit of the tree.
-    //    - Wrap each node with a presentation node (wrapper that adds helpers).
-    {
-        const auto make_pnode = [](const Node& node, PNode* parent) -> std::unique_ptr<PNode> {
-            if (node.type == Node::Type::Block) {
-                return std::make_unique<PBlock>(static_cast<const Block&>(node), parent);
-            } else if (node.type == Node::Type::Divider) {
-                if (parent->node.type == Node::Type::HLayout)
-                    return std::make_unique<PHDivider>(static_cast<const Divider&>(node), parent);
-                if (parent->node.type == Node::Type::VLayout)
-                    return std::make_unique<PVDivider>(static_cast<const Divider&>(node), parent);
-            } else if (node.type == Node::Type::HLayout) {
-                return std::make_unique<PHLayout>(static_cast<const HLayout&>(node), parent);
-            } else if (node.type == Node::Type::VLayout) {
-                return std::make_unique<PVLayout>(static_cast<const VLayout&>(node), parent);
-            }
-            return nullptr;
-        };
-
-        root = make_pnode(root_node, nullptr);
-
-        std::vector<PNode*> stack;
-        stack.push_back(&*root);
+    present_tree(root_node, nullptr);
+}
 
-        while (!stack.empty()) {
-            PNode* node = stack.back();
-            stack.pop_back();
+void Presenter::render(const Node& root_node, Surface& surface) {
+    present_tree(root_node, nullptr, &surface);
+}
 
-            if (node->node.type == Node::Type::HLayout || node->node.type == Node::Type::VLayout) {
-                // Wrap each child into a presentation node
-                auto* c = static_cast<PContainer*>(node);
-                c->children.resize(c->node.children.size());
-                for (uint32_t i = 0; i < c->children.size(); i++) {
-                    c->children[i] = make_pnode(*c->node.children[i], node);
-                    stack.push_back(&*c->children[i]);
-                }
-            }
+void Presenter::present_tree(const Node& root, Layout::Flatten flatten, Surface* surface) {
+    bool timed = StatsAvailable && collect_stats;
+    Stopwatch stopwatch {timed};
+
+    // Capacities of the storages of the presenter, to count the ones that grow during the frame
+    const auto capacities = [this] {
+        size_t band_capacities[3] {};
+        for (const Band& band : bands) {
+            band_capacities[0] += band.buffer.capacity();
+            band_capacities[1] += band.scratch.memory_usage().reserved;
+            band_capacities[2] += band.active.capacity();
         }
+        return std::array<size_t, 15> {buffer.capacity(),
+                                       layout.memory_usage().reserved,
+                                       plan.spans.capacity(),
+                                       plan.first.capacity(),
+                                       plan.starting.capacity(),
+                                       plan.ending.capacity(),
+                                       plan.ancestors.capacity(),
+                                       scratch.memory_usage().reserved,
+                                       active.capacity(),
+                                       bands.capacity(),
+                                       band_capacities[0],
+                                       band_capacities[1],
+                                       band_capacities[2],
+                                       front.cells.capacity(),
+                                       back.cells.capacity()};
+    };
+    auto initial_capacities = timed ? capacities() : decltype(capacities()) {};
+
+    // 1) Layout.
+    layout.build(root, mode == Mode::Retained, flatten);
+    uint64_t build_ns = stopwatch.lap();
+    layout.measure();
+    uint64_t measure_ns = stopwatch.lap();
+    layout.arrange();
+    plan_rows(layout, make_clip(viewport), plan);
+    uint64_t arrange_ns = stopwatch.lap();
+
+    // 2) Presentation (or rendering only).
+    bool changed = false;
+    if (surface) {
+        render_surface(*surface);
+    } else {
+        changed = present_layout();
     }
+    uint64_t render_ns = stopwatch.lap();
 
-    struct PostOrderPNodeStackEntry {
-        PNode* node;
-        uint32_t index {};
-    };
+    // 3) Output.
+    if (changed) {
+        sink.write(buffer);
+    }
+    uint64_t write_ns = stopwatch.lap();
+
+    if (timed) {
+        Clip clip = make_clip(viewport);
+        Stats& stats = last_stats;
+        stats.build_ns = build_ns;
+        stats.measure_ns = measure_ns;
+        stats.arrange_ns = arrange_ns;
+        stats.render_ns = render_ns;
+        stats.write_ns = write_ns;
+        stats.nodes = static_cast<uint32_t>(layout.boxes.size());
+        stats.measured_nodes = layout.measured();
+        stats.rows = std::min(layout.rows(), clip.bottom) - std::min(layout.rows(), clip.top);
+        stats.bytes = changed ? buffer.size() : 0;
+        stats.sgr_sequences = changed ? count_sgr(buffer) : 0;
+        stats.growths = 0;
+        auto final_capacities = capacities();
+        for (size_t i = 0; i < final_capacities.size(); i++) {
+            stats.growths += final_capacities[i] > initial_capacities[i];
+        }
+    }
+}
 
-    // 2) Compute dimensions of nodes with fixed size
-    //    and propagate information up to all the tree
-    //    (e.g. to containers)
-    {
-        std::vector<PostOrderPNodeStackEntry> stack {{&*root}};
+bool Presenter::present_layout() {
+    buffer.clear();
 
-        while (!stack.empty()) {
-            PostOrderPNodeStackEntry& entry = stack.back();
-            PNode* node = entry.node;
+    Clip clip = make_clip(viewport);
 
-            bool visit {true};
+    if (output == Output::Full) {
+        if (synchronized_update) {
+            buffer += SynchronizedUpdateBegin;
+        }
 
-            if (node->type & PNode::Type::Block) {
-                auto* b = static_cast<PBlock*>(node);
+        uint32_t rows = std::min(layout.rows(), clip.bottom) - std::min(layout.rows(), clip.top);
+
+        if (minimal_sgr) {
+            SgrStreamTarget target {buffer};
+            present_rows(layout, plan, target, scratch, active, clip);
+            target.finish();
+        } else if (pool && rows >= 2 * MinBandRows) {
+            // Split the rows in bands, present them in parallel and append them in order
+            struct Job {
+                Presenter& presenter;
+                const Clip& clip;
+                uint32_t rows;
+                uint32_t count;
+            } job {*this, clip, rows, std::min(pool->size() * 4, rows / MinBandRows)};
+
+            if (bands.size() < job.count) {
+                bands.resize(job.count);
+            }
 
-                // Compute block's dimensions
+            pool->run(job.count, [&job](uint32_t k) {
+                Band& band = job.presenter.bands[k];
+                Clip band_clip {job.clip};
+                band_clip.top = job.clip.top + static_cast<uint32_t>(uint64_t {job.rows} * k / job.count);
+                band_clip.bottom = job.clip.top + static_cast<uint32_t>(uint64_t {job.rows} * (k + 1) / job.count);
 
-                // Do not take ending empty lines into account for block's height
-                int32_t h = static_cast<int32_t>(b->node.lines.size()) - 1;
-                while (h >= 0 && b->node.lines[h].size() == 0) {
-                    h--;
-                }
-                b->height = std::max(0, h + 1);
+                band.buffer.clear();
+                StreamTarget target {band.buffer};
+                present_rows(job.presenter.layout, job.presenter.plan, target, band.scratch, band.active, band_clip);
+            });
 
-                if (b->node.width) {
-                    // Fixed width
-                    b->width = *b->node.width;
-                } else {
-                    // Variable width
-                    for (const auto& l : b->node.lines) {
-                        b->width = std::max(b->width.value_or(0), l.size().value);
-                    }
-                }
-            } else if (node->type & PNode::Type::HDivider) {
-                auto* d = static_cast<PDivider*>(node);
-                d->width = d->node.text.size();
-            } else if (node->type & PNode::Type::VDivider) {
-                auto* d = static_cast<PDivider*>(node);
-                d->height = 1;
-            } else if (node->type & PNode::Type::Container) {
-                const auto* c = static_cast<const PContainer*>(node);
-                if (entry.index < c->children.size()) {
-                    // Still children to visit
-                    uint32_t idx = entry.index++;
-                    stack.push_back({&*c->children[idx]});
-                    visit = false;
-                } else {
-                    // Compute container's dimensions
-                    if (node->type & PNode::Type::HLayout) {
-                        for (const auto& n : c->children) {
-                            node->width = node->width.value_or(0) + n->width.value_or(0);
-                            node->height = std::max(node->height.value_or(0), n->height.value_or(0));
-                        }
-                    } else if (node->type & PNode::Type::VLayout) {
-                        for (const auto& n : c->children) {
-                            node->width = std::max(node->width.value_or(0), n->width.value_or(0));
-                            node->height = node->height.value_or(0) + n->height.value_or(0);
-                        }
-                    }
-                }
+            for (uint32_t k = 0; k < job.count; k++) {
+                buffer += bands[k].buffer;
             }
+        } else {
+            StreamTarget target {buffer};
+            present_rows(layout, plan, target, scratch, active, clip);
+        }
 
-            if (visit) {
-                stack.pop_back();
-            }
+        if (synchronized_update) {
+            buffer += SynchronizedUpdateEnd;
         }
+
+        return true;
     }
 
-    // 3) Propagate dimensions down to automatically sized nodes (e.g. dividers).
-    {
-        std::vector<PNode*> stack {&*root};
+    render_surface(back);
+    bool changed = present_diff();
+    std::swap(front, back);
+    return changed;
+}
+
+void Presenter::render_surface(Surface& surface) {
+    Clip clip = make_clip(viewport);
 
-        while (!stack.empty()) {
-            PNode* node = stack.back();
-            stack.pop_back();
+    uint32_t width = layout.boxes[0].width;
+    surface.width = std::min(width - std::min(width, clip.left), clip.right - clip.left);
+    surface.cells.clear();
 
-            if (!node->width) {
-                node->width = node->parent ? node->parent->width.value_or(0) : 0;
-            }
-            if (!node->height) {
-                node->height = node->parent ? node->parent->height.value_or(0) : 0;
-            }
+    CellTarget target {surface};
+    present_rows(layout, plan, target, scratch, active, clip);
 
-            if (node->type & PNode::Type::Container) {
-                const auto* c = static_cast<const PContainer*>(node);
-                for (const auto& n : c->children) {
-                    stack.push_back(&*n);
-                }
-            }
-        }
+    surface.height = target.y + (target.x > 0 ? 1 : 0);
+    surface.cells.resize(surface.width * surface.height);
+}
+
+// Writes the changes between the front and the back surfaces.
+// Returns whether there is any.
+bool Presenter::present_diff() {
+    if (synchronized_update) {
+        buffer += SynchronizedUpdateBegin;
+    }
+    size_t begin = buffer.size();
+
+    // The whole frame is repainted if its size changed
+    // (or if there is no previous frame at all)
+    bool repaint = front.width != back.width || front.height != back.height;
+    if (repaint) {
+        // Move the cursor to the top left corner and clear the screen
+        buffer += "\033[H\033[2J";
     }
 
-    // 4) Update block's width to fill containers space.
-    //    This applies to:
-    //    * All the blocks of vertical layouts.
-    //    * Last blocks of horizontal layouts.
-    {
-        std::vector<PNode*> stack {&*root};
+    // The style of the terminal is reset at the end of each frame
+    Style style {};
 
-        while (!stack.empty()) {
-            PNode* node = stack.back();
-            stack.pop_back();
+    // Position of the cursor (unknown at the beginning)
+    uint32_t cx = UINT32_MAX;
+    uint32_t cy = UINT32_MAX;
 
-            if (node->type & PNode::Type::Container) {
-                const auto* c = static_cast<PContainer*>(node);
+    for (uint32_t y = 0; y < back.height; y++) {
+        const Cell* row = back.cells.data() + y * back.width;
+        const Cell* prev_row = repaint ? nullptr : front.cells.data() + y * front.width;
 
-                if (node->type & PNode::Type::HLayout) {
-                    // The last child fills the remaining horizontal layout width
-                    uint32_t children_width = 0;
-                    for (uint32_t i = 0; i < c->children.size() - 1; i++) {
-                        children_width += *c->children[i]->width;
-                    }
-                    c->children.back()->width = *node->width - children_width;
-                } else if (node->type & PNode::Type::VLayout) {
-                    // All the children fills the entire the vertical layout width
-                    for (auto& child : c->children) {
-                        child->width = node->width;
-                    }
-                }
+        for (uint32_t x = 0; x < back.width; x++) {
+            const Cell& cell = row[x];
 
-                for (const auto& n : c->children) {
-                    stack.push_back(&*n);
-                }
+            // Continuation cells are written along with their glyph
+            if (cell.glyph == Cell::Glyph {}) {
+                continue;
             }
-        }
-    }
 
-    // 5) Find ending blocks (the ones at the right of the entire content)
-    //    An ending block is defined by the following rule:
-    //    A block is an ending block unless it is not part of the rightmost
-    //    branch of any Horizontal Layout ancestors it has.
-    {
-        std::vector<PNode*> stack {&*root};
+            if (repaint ? cell == Cell {} : cell == prev_row[x]) {
+                continue;
+            }
 
-        while (!stack.empty()) {
-            PNode* node = stack.back();
-            stack.pop_back();
+            if (cx != x || cy != y) {
+                move_cursor(buffer, y + 1, x + 1);
+            }
 
-            if (node->type & PNode::Type::Content) {
-                static_cast<PContent*>(node)->endl = true;
-            } else if (node->node.type == Node::Type::HLayout) {
-                const auto* h = static_cast<const PHLayout*>(node);
-                if (!h->children.empty()) {
-                    // Only the blocks of the right most branch are candidates.
-                    stack.push_back(&*h->children.back());
-                }
-            } else if (node->node.type == Node::Type::VLayout) {
-                const auto* v = static_cast<const PVLayout*>(node);
-                for (const auto& n : v->children) {
-                    stack.push_back(&*n);
+            if (cell.style != style) {
+                if (minimal_sgr) {
+                    cell.style.sgr(buffer, style);
+                } else {
+                    cell.style.sgr(buffer);
                 }
+                style = cell.style;
             }
-        }
-    }
 
-    // 6) Presentation.
-    //    The logic is the following:
-    //
-    //    [Container]
-    //
-    //    - Horizontal Layout:
-    //          Processed in parallel.
-    //          When it is visited all its children are visited too.
-    //    - Vertical Layout
-    //          Processed sequentially.
-    //          When it is visited only the first child for which the render
-    //          is not finished is visited.
-    //
-    //    [Content]
-    //
-    //    - Block/Dividers
-    //          When it is visited it pushes the next line to the output stream.
-    //          The lines are truncated/expanded to exactly fill the block's width.
-    //          If there are no more lines to render, it pushes empty lines
-    //          to fill the block's width.
-    do {
-        // A) Presentation.
-        {
-            std::vector<PNode*> stack {&*root};
-
-            while (!stack.empty()) {
-                PNode* node = stack.back();
-                stack.pop_back();
-
-                if (node->type & PNode::Type::Content) {
-                    auto* c = static_cast<PContent*>(node);
-
-                    if (!c->done) {
-                        if (node->type & PNode::Type::Block) {
-                            auto* b = static_cast<PBlock*>(node);
-
-                            // Present next line
-                            const Text& raw_line = b->node.lines[b->line];
-                            Text t {};
-                            uint32_t w = *b->width;
-                            if (raw_line.size() < w)
-                                t = raw_line.rpad(Text::Length {w});
-                            else if (raw_line.size() > w)
-                                t = raw_line.substr(Text::RawIndex {0}, Text::Length {w});
-                            else
-                                t = raw_line;
-                            os << t.str();
-
-                            // Always push the reset attribute in case substr truncated it
-                            os << reset().str();
-                        } else if (node->type & PNode::Type::Divider) {
-                            auto* d = static_cast<PDivider*>(node);
-
-                            for (uint32_t i = 0; i < *node->width; i += d->node.text.size()) {
-                                os << d->node.text.str();
-                            }
-                        }
-                    } else {
-                        // Nothing more to render: just fill the node space
-                        os << std::string(*c->width, ' ');
-                    }
+            buffer += cell.glyph_str();
 
-                    // Go to a new line if this is an ending content
-                    if (c->endl) {
-                        os << std::endl;
-                    }
-
-                    c->line++;
-                } else if (node->node.type == Node::Type::HLayout) {
-                    auto* h = static_cast<PHLayout*>(node);
-                    // Push reversed to visit pre-order
-                    // Always push all the nodes: they are all processed in parallel.
-                    for (int32_t i = static_cast<int32_t>(h->children.size()) - 1; i >= 0; i--) {
-                        stack.push_back(&*h->children[i]);
-                    }
-                } else if (node->node.type == Node::Type::VLayout) {
-                    auto* v = static_cast<PVLayout*>(node);
-                    if (!v->children.empty()) {
-                        // Push the first node that has not done yet.
-                        // If every node is done, we push the last one,
-                        // so that it will fill the remaining space.
-                        uint32_t i = 0;
-                        while (i < v->children.size() - 1 && v->children[i]->done) {
-                            i++;
-                        }
-                        stack.push_back(&*v->children[i]);
-                    }
-                }
+            cx = x + 1;
+            cy = y;
+            while (cx < back.width && row[cx].glyph == Cell::Glyph {}) {
+                cx++;
             }
         }
+    }
 
-        // B) Propagate the done flag of the blocks up to all the tree.
-        {
-            std::vector<PostOrderPNodeStackEntry> stack {{&*root}};
+    if (buffer.size() == begin) {
+        // Nothing changed
+        return false;
+    }
 
-            while (!stack.empty()) {
-                PostOrderPNodeStackEntry& entry = stack.back();
-                PNode* node = entry.node;
+    if (style != Style {}) {
+        buffer += ResetSgr;
+    }
 
-                bool visit {true};
+    // Leave the cursor below the frame
+    move_cursor(buffer, back.height + 1, 1);
 
-                if (node->type & PNode::Type::Content) {
-                    auto* c = static_cast<PContent*>(node);
-                    c->done = c->line >= *c->height;
-                } else if (node->type & PNode::Type::Container) {
-                    const auto* c = static_cast<const PContainer*>(node);
-                    if (entry.index < c->children.size()) {
-                        // Still children to visit
-                        uint32_t idx = entry.index++;
-                        stack.push_back({&*c->children[idx]});
-                        visit = false;
-                    } else {
-                        // Mark this container as done if all the children have done
-                        node->done = true;
-                        for (const auto& n : c->children) {
-                            node->done &= n->done;
-                        }
-                    }
-                }
+    if (synchronized_update) {
+        buffer += SynchronizedUpdateEnd;
+    }
 
-                if (visit) {
-                    stack.pop_back();
-                }
-            }
-        }
-    } while (!root->done);
+    return true;
 }
 } // namespace Tui
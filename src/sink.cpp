@@ -0,0 +1,34 @@
+#include "tui/sink.h"
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+namespace Tui {
+void StreamSink::write(std::string_view frame) {
+    os.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+    os.flush();
+}
+
+void FdSink::write(std::string_view frame) {
+    const char* data = frame.data();
+    size_t size = frame.size();
+
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // Non-blocking descriptor: wait until it can be written again
+                pollfd pfd {fd, POLLOUT, 0};
+                if (::poll(&pfd, 1, -1) >= 0 || errno == EINTR)
+                    continue;
+            }
+            // Unrecoverable error: drop the rest of the frame
+            return;
+        }
+        data += n;
+        size -= n;
+    }
+}
+} // namespace Tui
@@ -0,0 +1,227 @@
+#include "tui/style.h"
+#include "tui/sgr.h"
+
+namespace Tui {
+namespace {
+    void append_color(std::string& out, uint32_t color, uint32_t base) {
+        // base is 30 for the foreground and 40 for the background
+        uint32_t type = color & Style::Color::Mask;
+        if (type == Style::Color::Palette) {
+            uint32_t index = color & 0xFF;
+            if (index < 8) {
+                append_parameter(out, base + index);
+            } else if (index < 16) {
+                append_parameter(out, base + 60 + index - 8);
+            } else {
+                append_parameter(out, base + 8);
+                out += ";5;";
+                append_parameter(out, index);
+            }
+        } else if (type == Style::Color::Rgb) {
+            append_parameter(out, base + 8);
+            out += ";2;";
+            append_parameter(out, (color >> 16) & 0xFF);
+            out += ';';
+            append_parameter(out, (color >> 8) & 0xFF);
+            out += ';';
+            append_parameter(out, color & 0xFF);
+        }
+    }
+
+    uint32_t digits(uint32_t value) {
+        return value < 10 ? 1 : value < 100 ? 2 : 3;
+    }
+
+    uint32_t color_length(uint32_t color, uint32_t base) {
+        // Length of the parameters written by append_color
+        uint32_t type = color & Style::Color::Mask;
+        if (type == Style::Color::Palette) {
+            uint32_t index = color & 0xFF;
+            return index < 8 ? 2 : index < 16 ? digits(base + 60 + index - 8) : 5 + digits(index);
+        }
+        if (type == Style::Color::Rgb) {
+            return 7 + digits((color >> 16) & 0xFF) + digits((color >> 8) & 0xFF) + digits(color & 0xFF);
+        }
+        return 0;
+    }
+
+    uint32_t sgr_length(const Style& style) {
+        // Length of the sequence written by Style::sgr(out)
+        uint32_t length = 4;
+        for (uint32_t i = 0; i < 9; i++) {
+            if (style.attrs & (1 << i)) {
+                length += 2;
+            }
+        }
+        if (style.fg != Style::Color::Default) {
+            length += 1 + color_length(style.fg, 30);
+        }
+        if (style.bg != Style::Color::Default) {
+            length += 1 + color_length(style.bg, 40);
+        }
+        return length;
+    }
+} // namespace
+
+bool Style::apply(std::string_view seq) {
+    // Most common sequence, ending every decoration
+    if (seq == ResetSgr) {
+        *this = Style {};
+        return true;
+    }
+    if (seq.size() < 3 || seq[0] != '\033' || seq[1] != '[' || seq.back() != 'm') {
+        return false;
+    }
+
+    // Parse the parameters first: the style is updated only if the sequence is well-formed
+    constexpr uint32_t MaxParams = 32;
+    uint32_t params[MaxParams];
+    uint32_t n = 0;
+    uint32_t value = 0;
+    for (size_t i = 2; i < seq.size() - 1; i++) {
+        char c = seq[i];
+        if (c >= '0' && c <= '9') {
+            value = value * 10 + (c - '0');
+        } else if (c == ';' && n < MaxParams - 1) {
+            params[n++] = value;
+            value = 0;
+        } else {
+            return false;
+        }
+    }
+    params[n++] = value;
+
+    Style s {*this};
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t p = params[i];
+        if (p == 0) {
+            s = Style {};
+        } else if (p >= 1 && p <= 9) {
+            s.attrs |= 1 << (p - 1);
+        } else if (p == 22) {
+            s.attrs &= ~(Attr::Bold | Attr::Dim);
+        } else if (p == 25) {
+            s.attrs &= ~(Attr::Blink | Attr::RapidBlink);
+        } else if (p >= 23 && p <= 29 && p != 26) {
+            s.attrs &= ~(1 << (p - 21));
+        } else if ((p >= 30 && p <= 37) || (p >= 40 && p <= 47)) {
+            (p < 40 ? s.fg : s.bg) = Color::Palette | (p % 10);
+        } else if ((p >= 90 && p <= 97) || (p >= 100 && p <= 107)) {
+            (p < 100 ? s.fg : s.bg) = Color::Palette | (8 + p % 10);
+        } else if (p == 39) {
+            s.fg = Color::Default;
+        } else if (p == 49) {
+            s.bg = Color::Default;
+        } else if (p == 38 || p == 48) {
+            uint32_t& color = p == 38 ? s.fg : s.bg;
+            if (i + 2 < n && params[i + 1] == 5) {
+                color = Color::Palette | (params[i + 2] & 0xFF);
+                i += 2;
+            } else if (i + 4 < n && params[i + 1] == 2) {
+                color = Color::Rgb | (params[i + 2] & 0xFF) << 16 | (params[i + 3] & 0xFF) << 8 |
+                        (params[i + 4] & 0xFF);
+                i += 4;
+            } else {
+                return false;
+            }
+        } else {
+            // Not represented (e.g. an underline color, whose next parameters are not SGR codes)
+            return false;
+        }
+    }
+
+    *this = s;
+    return true;
+}
+
+void Style::sgr(std::string& out) const {
+    out += "\033[0";
+    for (uint32_t i = 0; i < 9; i++) {
+        if (attrs & (1 << i)) {
+            out += ';';
+            out += static_cast<char>('1' + i);
+        }
+    }
+    if (fg != Color::Default) {
+        out += ';';
+        append_color(out, fg, 30);
+    }
+    if (bg != Color::Default) {
+        out += ';';
+        append_color(out, bg, 40);
+    }
+    out += 'm';
+}
+
+void Style::sgr(std::string& out, const Style& from) const {
+    if (*this == from) {
+        return;
+    }
+    if (*this == Style {}) {
+        out += "\033[0m";
+        return;
+    }
+
+    // Write the changes only, and fall back to the full sequence
+    // if shorter (never from the default style)
+    size_t begin = out.size();
+
+    char separator = '[';
+    const auto param = [&out, &separator](uint32_t value) {
+        if (separator == '[')
+            out += '\033';
+        out += separator;
+        append_parameter(out, value);
+        separator = ';';
+    };
+
+    // Attributes sharing their reset parameter (bold and dim, blinks)
+    // are set again if only one of them has been removed
+    auto removed = static_cast<Attr::AttrType>(from.attrs & ~attrs);
+    auto added = static_cast<Attr::AttrType>(attrs & ~from.attrs);
+    if (removed & (Attr::Bold | Attr::Dim)) {
+        param(22);
+        added |= attrs & (Attr::Bold | Attr::Dim);
+    }
+    if (removed & (Attr::Blink | Attr::RapidBlink)) {
+        param(25);
+        added |= attrs & (Attr::Blink | Attr::RapidBlink);
+    }
+    for (uint32_t i : {2, 3, 6, 7, 8}) {
+        if (removed & (1 << i)) {
+            param(21 + i);
+        }
+    }
+    for (uint32_t i = 0; i < 9; i++) {
+        if (added & (1 << i)) {
+            param(1 + i);
+        }
+    }
+
+    if (fg != from.fg) {
+        if (fg == Color::Default) {
+            param(39);
+        } else {
+            out += separator == '[' ? "\033[" : ";";
+            separator = ';';
+            append_color(out, fg, 30);
+        }
+    }
+    if (bg != from.bg) {
+        if (bg == Color::Default) {
+            param(49);
+        } else {
+            out += separator == '[' ? "\033[" : ";";
+            separator = ';';
+            append_color(out, bg, 40);
+        }
+    }
+    out += 'm';
+
+    if (from != Style {} && out.size() - begin > sgr_length(*this)) {
+        out.resize(begin);
+        sgr(out);
+    }
+}
+} // namespace Tui
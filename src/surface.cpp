@@ -0,0 +1,68 @@
+#include "tui/surface.h"
+#include <cstring>
+
+namespace Tui {
+namespace {
+    // Appends the glyphs of the cells [begin, end).
+    void append_glyphs(std::string& out, const Cell* begin, const Cell* end) {
+        // Each glyph is copied whole into the string resized for the longest glyphs,
+        // then the next one is written after its actual bytes.
+        size_t offset = out.size();
+        out.resize(offset + static_cast<size_t>(end - begin) * sizeof(Cell::Glyph));
+        char* p = out.data() + offset;
+        for (const Cell* cell = begin; cell != end; cell++) {
+            const Cell::Glyph& g = cell->glyph;
+            std::memcpy(p, g.data(), sizeof(g));
+            // Continuation cells of wide glyphs have no glyph of their own
+            p += g[0] ? (g[1] ? (g[2] ? (g[3] ? 4 : 3) : 2) : 1) : 0;
+        }
+        out.resize(static_cast<size_t>(p - out.data()));
+    }
+} // namespace
+
+std::string Surface::text() const {
+    std::string out;
+    append_text(out);
+    return out;
+}
+
+void Surface::append_text(std::string& out) const {
+    out.reserve(out.size() + cells.size() + height);
+    for (uint32_t y = 0; y < height; y++) {
+        const Cell* row = cells.data() + y * width;
+        append_glyphs(out, row, row + width);
+        out += '\n';
+    }
+}
+
+std::string Surface::ansi() const {
+    std::string out;
+    append_ansi(out);
+    return out;
+}
+
+void Surface::append_ansi(std::string& out) const {
+    out.reserve(out.size() + cells.size() + height);
+    Style style {};
+    for (uint32_t y = 0; y < height; y++) {
+        const Cell* row = cells.data() + y * width;
+        const Cell* end = row + width;
+        for (const Cell* cell = row; cell != end;) {
+            // Cells of the same style are written at once
+            const Cell* run = cell;
+            while (cell != end && cell->style == style) {
+                cell++;
+            }
+            append_glyphs(out, run, cell);
+            if (cell != end) {
+                cell->style.sgr(out, style);
+                style = cell->style;
+            }
+        }
+        out += '\n';
+    }
+
+    // Leave the terminal in its default style
+    Style {}.sgr(out, style);
+}
+} // namespace Tui
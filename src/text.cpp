@@ -1,24 +1,138 @@
 #include "tui/text.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
 
 namespace Tui {
+namespace {
+    constexpr unsigned char Escape = 0x1B;
+
+    // Length of the prefix of plain characters (ASCII other than the escape character).
+    size_t plain_prefix(const char* data, size_t size) {
+        size_t i = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+        // 16 bytes at a time: stop at the first chunk containing
+        // a byte with the high bit set or an escape character.
+        const __m128i escape = _mm_set1_epi8(static_cast<char>(Escape));
+        for (; i + 16 <= size; i += 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            if (_mm_movemask_epi8(_mm_or_si128(chunk, _mm_cmpeq_epi8(chunk, escape)))) {
+                break;
+            }
+        }
+#endif
+        for (; i < size; i++) {
+            auto ch = static_cast<unsigned char>(data[i]);
+            if (ch >= 0x80 || ch == Escape) {
+                break;
+            }
+        }
+        return i;
+    }
+
+    // Number of columns of a code point.
+    uint32_t width_of(uint32_t cp) {
+        // Combining marks and zero width characters
+        if ((cp >= 0x0300 && cp <= 0x036F) || (cp >= 0x200B && cp <= 0x200F) || (cp >= 0xFE00 && cp <= 0xFE0F)) {
+            return 0;
+        }
+        // East Asian wide and fullwidth characters, emoji
+        if ((cp >= 0x1100 && cp <= 0x115F) || (cp >= 0x2E80 && cp <= 0xA4CF && cp != 0x303F) ||
+            (cp >= 0xAC00 && cp <= 0xD7A3) || (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0xFE30 && cp <= 0xFE4F) ||
+            (cp >= 0xFF00 && cp <= 0xFF60) || (cp >= 0xFFE0 && cp <= 0xFFE6) || (cp >= 0x1F300 && cp <= 0x1F64F) ||
+            (cp >= 0x1F900 && cp <= 0x1F9FF) || (cp >= 0x20000 && cp <= 0x3FFFD)) {
+            return 2;
+        }
+        return 1;
+    }
+
+    // Bytes of the escape sequence at the beginning of the string.
+    // An escape character not followed by a sequence is taken alone
+    // (e.g. before a new line or a UTF-8 character).
+    size_t escape_length(std::string_view str) {
+        if (str.size() < 2 || str[1] < 0x20 || str[1] > 0x7E) {
+            return 1;
+        }
+        size_t i = 2;
+        if (str[1] == '[') {
+            // CSI: parameters and intermediate bytes, then the final byte
+            while (i < str.size() && str[i] >= 0x20 && str[i] <= 0x3F) {
+                i++;
+            }
+            if (i < str.size() && str[i] >= 0x40 && str[i] <= 0x7E) {
+                i++;
+            }
+        } else if (str[1] == ']') {
+            // OSC: terminated by BEL or ST (ESC \)
+            while (i < str.size() && str[i] != '\a' && str[i] != static_cast<char>(Escape)) {
+                i++;
+            }
+            if (i < str.size()) {
+                i += str[i] == '\a' ? 1 : std::min<size_t>(2, str.size() - i);
+            }
+        } else if (str[1] <= 0x2F) {
+            // Intermediate bytes, then the final byte
+            while (i < str.size() && str[i] >= 0x20 && str[i] <= 0x2F) {
+                i++;
+            }
+            if (i < str.size() && str[i] >= 0x30 && str[i] <= 0x7E) {
+                i++;
+            }
+        }
+        return i;
+    }
+
+    // Bytes of the UTF-8 code point at the beginning of the string,
+    // 1 if it is not a valid one. The code point is stored in cp.
+    size_t code_point_length(std::string_view str, uint32_t& cp) {
+        auto lead = static_cast<unsigned char>(str[0]);
+        size_t n = 0;
+        if (lead >= 0xC2 && lead <= 0xDF)
+            n = 2;
+        else if (lead >= 0xE0 && lead <= 0xEF)
+            n = 3;
+        else if (lead >= 0xF0 && lead <= 0xF4)
+            n = 4;
+        if (n == 0 || n > str.size()) {
+            return 1;
+        }
+        cp = lead & (0x7F >> n);
+        for (size_t i = 1; i < n; i++) {
+            auto ch = static_cast<unsigned char>(str[i]);
+            if ((ch & 0xC0) != 0x80) {
+                return 1;
+            }
+            cp = (cp << 6) | (ch & 0x3F);
+        }
+        return n;
+    }
+} // namespace
+
 Text::Text() = default;
 
 Text::Text(const Token& t) {
-    length = t.size;
-    tokens.push_back(t);
+    append(t.string, t.size);
 }
 
 Text::Text(Token&& t) {
-    length = t.size;
-    tokens.emplace_back(std::move(t));
+    append(t.string, t.size);
+}
+
+Text::Text(const Number& number) {
+    *this += number;
 }
 
 std::string Text::str() const {
-    std::string s;
-    for (const auto& t : tokens) {
-        s += t.string;
-    }
-    return s;
+    return bytes;
+}
+
+std::string_view Text::view() const {
+    return bytes;
 }
 
 Text::Length Text::size() const {
@@ -31,31 +145,54 @@ Text Text::substr(RawIndex start_r) const {
 
 Text Text::substr(RawIndex start_r, RawLength len_r) const {
     Text text;
-    uint32_t n = 0;
-    for (uint32_t i = start_r; i < tokens.size() && n < len_r; i++) {
-        text += tokens[i];
-        n++;
+    if (start_r < count) {
+        text.append(*this, start_r, start_r + std::min<uint32_t>(len_r, count - start_r));
     }
-
     return text;
 }
 
 Text Text::substr(RawIndex start_r, Length len) const {
     Text text;
-    uint32_t n = 0;
-    for (uint32_t i = start_r; i < tokens.size() && n < len; i++) {
-        text += tokens[i];
-        n += tokens[i].size;
+    if (start_r < count) {
+        text.append(*this, start_r, end_of(start_r, len));
     }
     return text;
 }
 
-std::optional<Text::RawIndex> Text::find(char ch, RawIndex pos_r, RawLength len_r) const {
+std::string_view Text::view(Length len) const {
+    return std::string_view {bytes}.substr(0, offset_of(end_of(0, len)));
+}
+
+std::string_view Text::view(Length len, Length& columns) const {
     uint32_t n = 0;
-    for (uint32_t i = pos_r; i < tokens.size() && n < len_r; i++, n++) {
-        const auto& token = tokens[i];
-        if (!token.string.empty() && token.string[0] == ch) {
-            return RawIndex {i};
+    uint32_t end = end_of(0, len, &n);
+    columns = Length {n};
+    return std::string_view {bytes}.substr(0, offset_of(end));
+}
+
+std::optional<Text::RawIndex> Text::find(char ch, RawIndex pos_r, RawLength len_r) const {
+    if (pos_r >= count) {
+        return std::nullopt;
+    }
+
+    uint32_t i = pos_r;
+    uint32_t end = i + std::min<uint32_t>(len_r, count - i);
+    auto run = run_at(i);
+    while (i < end) {
+        if (run != runs.end() && run->index == i) {
+            if (run->bytes > 0 && bytes[run->offset] == ch) {
+                return RawIndex {i};
+            }
+            i++;
+            run++;
+        } else {
+            uint32_t chunk_end = std::min(run != runs.end() ? run->index : count, end);
+            const char* chunk = bytes.data() + offset_of(i);
+            const auto* found = static_cast<const char*>(std::memchr(chunk, ch, chunk_end - i));
+            if (found) {
+                return RawIndex {static_cast<uint32_t>(i + (found - chunk))};
+            }
+            i = chunk_end;
         }
     }
     return std::nullopt;
@@ -65,51 +202,215 @@ Text Text::rpad(Length len, char ch) const {
     if (length >= len) {
         return *this;
     }
-    return *this + Text {std::string(len - length, ch)};
+    Text text {*this};
+    text.bytes.append(len - length, ch);
+    text.count += len - length;
+    text.length = len;
+    return text;
 }
 
 Text Text::lpad(Length len, char ch) const {
     if (length >= len) {
         return *this;
     }
-    return Text {std::string(len - length, ch)} + *this;
+    Text text {std::string(len - length, ch)};
+    text += *this;
+    return text;
 }
 
 Text& Text::operator=(const Token& token) {
-    length = token.size;
-    tokens.push_back(token);
+    *this = Text {token};
     return *this;
 }
 
 Text& Text::operator=(Token&& token) {
-    length = token.size;
-    tokens.emplace_back(std::move(token));
+    *this = Text {std::move(token)};
     return *this;
 }
 
 Text& Text::operator+=(const Token& t) {
-    length = length + t.size;
-    tokens.push_back(t);
+    append(t.string, t.size);
     return *this;
 }
 
 Text& Text::operator+=(Token&& t) {
-    length = length + t.size;
-    tokens.emplace_back(std::move(t));
+    append(t.string, t.size);
     return *this;
 }
 
 Text& Text::operator+=(const Text& s) {
-    tokens.insert(tokens.end(), s.tokens.begin(), s.tokens.end());
-    length = length + s.length.value;
+    append(s, 0, s.count);
     return *this;
 }
 
+Text& Text::operator+=(const Number& number) {
+    // The characters are composed on the stack from the last one, then appended at once:
+    // the digits and the sign, padded to the width (at most 255 characters)
+    static_assert(Number::MaxDigits + 1 <= std::numeric_limits<decltype(Number::width)>::max());
+    char buffer[std::numeric_limits<decltype(Number::width)>::max()];
+    char* const end = buffer + sizeof(buffer);
+    char* begin = end;
+
+    uint64_t value = number.value;
+    if (number.base == 10) {
+        do {
+            *--begin = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value);
+    } else {
+        const char* digits = number.upper ? "0123456789ABCDEF" : "0123456789abcdef";
+        uint32_t shift = number.base == 16 ? 4 : 1;
+        do {
+            *--begin = digits[value & (number.base - 1)];
+            value >>= shift;
+        } while (value);
+    }
+
+    const auto width = static_cast<ptrdiff_t>(number.width);
+    if (number.fill == '0') {
+        while (end - begin < width - number.negative) {
+            *--begin = '0';
+        }
+    }
+    if (number.negative) {
+        *--begin = '-';
+    }
+    while (end - begin < width) {
+        *--begin = ' ';
+    }
+
+    append_plain(std::string_view {begin, static_cast<size_t>(end - begin)});
+    return *this;
+}
+
+void Text::clear() {
+    bytes.clear();
+    runs.clear();
+    count = 0;
+    length = Length {0};
+}
+
+MemoryUsage Text::memory_usage() const {
+    MemoryUsage usage;
+    usage.add_object(sizeof(Text));
+    usage.add_storage(bytes);
+    usage.add_storage(runs);
+    usage.tokens = count;
+    return usage;
+}
+
 Text operator+(const Text& text1, const Text& text2) {
     Text text;
+    text.bytes.reserve(text1.bytes.size() + text2.bytes.size());
     text += text1;
     text += text2;
     return text;
 }
 
-} // namespace Tui
\ No newline at end of file
+void Text::append(std::string_view str) {
+    size_t n = plain_prefix(str.data(), str.size());
+    if (n < str.size()) {
+        bytes.reserve(bytes.size() + str.size());
+    }
+
+    while (!str.empty()) {
+        append_plain(str.substr(0, n));
+        str.remove_prefix(n);
+        if (str.empty()) {
+            break;
+        }
+
+        if (static_cast<unsigned char>(str[0]) == Escape) {
+            n = escape_length(str);
+            append(str.substr(0, n), 0);
+        } else {
+            uint32_t cp = 0;
+            n = code_point_length(str, cp);
+            append(str.substr(0, n), n == 1 ? 1 : width_of(cp));
+        }
+        str.remove_prefix(n);
+        n = plain_prefix(str.data(), str.size());
+    }
+}
+
+void Text::append_plain(std::string_view str) {
+    bytes.append(str);
+    count += str.size();
+    length = length + str.size();
+}
+
+void Text::append(std::string_view str, uint32_t size) {
+    if (str.size() != 1 || size != 1) {
+        runs.push_back({count, static_cast<uint32_t>(bytes.size()), static_cast<uint32_t>(str.size()), size});
+    }
+    bytes.append(str);
+    count++;
+    length = length + size;
+}
+
+void Text::append(const Text& text, uint32_t start, uint32_t end) {
+    uint32_t begin_offset = text.offset_of(start);
+    uint32_t end_offset = text.offset_of(end);
+
+    // Plain characters are 1 column each: the display length is the number of
+    // tokens adjusted by the size of the runs in the range.
+    uint32_t len = end - start;
+    for (auto run = text.run_at(start); run != text.runs.end() && run->index < end; run++) {
+        runs.push_back({count + run->index - start, static_cast<uint32_t>(bytes.size()) + run->offset - begin_offset,
+                        run->bytes, run->size});
+        len = len - 1 + run->size;
+    }
+
+    bytes.append(text.bytes, begin_offset, end_offset - begin_offset);
+    count += end - start;
+    length = length + len;
+}
+
+uint32_t Text::end_of(uint32_t start, uint32_t len, uint32_t* columns) const {
+    // Take tokens until the requested display length is reached:
+    // plain characters are consumed in chunks, runs one by one.
+    // A wide character that does not fit is not taken (nor the tokens after it).
+    uint32_t i = start;
+    uint32_t n = 0;
+    auto run = run_at(i);
+    while (i < count && n < len) {
+        if (run != runs.end() && run->index == i) {
+            if (run->size > len - n) {
+                break;
+            }
+            n += run->size;
+            i++;
+            run++;
+        } else {
+            uint32_t chunk_end = run != runs.end() ? run->index : count;
+            uint32_t k = std::min(chunk_end - i, len - n);
+            n += k;
+            i += k;
+        }
+    }
+    if (columns) {
+        *columns = n;
+    }
+    return i;
+}
+
+uint32_t Text::offset_of(uint32_t index) const {
+    auto run = run_at(index);
+    if (run != runs.end() && run->index == index) {
+        return run->offset;
+    }
+    if (run == runs.begin()) {
+        return index;
+    }
+    --run;
+    return run->offset + run->bytes + (index - run->index - 1);
+}
+
+std::vector<Text::Run>::const_iterator Text::run_at(uint32_t index) const {
+    // First run whose index is not less than the given one
+    return std::lower_bound(runs.begin(), runs.end(), index, [](const Run& run, uint32_t i) {
+        return run.index < i;
+    });
+}
+
+} // namespace Tui
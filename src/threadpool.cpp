@@ -0,0 +1,85 @@
+#include "tui/threadpool.h"
+
+namespace Tui {
+ThreadPool::ThreadPool(uint32_t threads) {
+    for (uint32_t i = 1; i < threads; i++) {
+        workers.emplace_back([this] {
+            work();
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock {mutex};
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+uint32_t ThreadPool::size() const {
+    return static_cast<uint32_t>(workers.size()) + 1;
+}
+
+void ThreadPool::run(uint32_t n, const std::function<void(uint32_t)>& f) {
+    if (workers.empty() || n <= 1) {
+        for (uint32_t i = 0; i < n; i++) {
+            f(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard lock {mutex};
+        job = &f;
+        count = n;
+        next = 0;
+        finished = 0;
+        batch++;
+    }
+    wake.notify_all();
+
+    run_jobs();
+
+    // Wait for the workers still running a job of this batch
+    std::unique_lock lock {mutex};
+    done.wait(lock, [this] {
+        return finished == workers.size();
+    });
+    job = nullptr;
+}
+
+void ThreadPool::work() {
+    uint64_t last_batch = 0;
+    while (true) {
+        {
+            std::unique_lock lock {mutex};
+            wake.wait(lock, [this, last_batch] {
+                return stop || batch != last_batch;
+            });
+            if (stop) {
+                return;
+            }
+            last_batch = batch;
+        }
+
+        run_jobs();
+
+        {
+            std::lock_guard lock {mutex};
+            finished++;
+        }
+        done.notify_one();
+    }
+}
+
+void ThreadPool::run_jobs() {
+    // Jobs are taken one by one until none is left
+    for (uint32_t i = next++; i < count; i = next++) {
+        (*job)(i);
+    }
+}
+} // namespace Tui